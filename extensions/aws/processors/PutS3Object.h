@@ -21,6 +21,7 @@
 #pragma once
 
 #include <sstream>
+#include <streambuf>
 #include <utility>
 #include <vector>
 #include <memory>
@@ -141,6 +142,15 @@ class PutS3Object : public core::Processor {
       if (flow_size_ > MAX_SIZE) {
         return -1;
       }
+      const uint8_t* view;
+      size_t view_size;
+      if (stream->getUnreadView(view, view_size)) {
+        // upload straight from the content already in memory
+        read_size_ = std::min<uint64_t>(flow_size_, view_size);
+        ContentViewStreamBuf view_buffer(view, static_cast<size_t>(read_size_));
+        result_ = s3_wrapper_->putObject(options_, std::make_shared<Aws::IOStream>(&view_buffer));
+        return read_size_;
+      }
       std::vector<uint8_t> buffer;
       auto data_stream = std::make_shared<std::stringstream>();
       buffer.reserve(BUFFER_SIZE);
@@ -162,6 +172,36 @@ class PutS3Object : public core::Processor {
       return read_size_;
     }
 
+   private:
+    // Read only stream buffer handing content held in memory to the SDK without copying it
+    class ContentViewStreamBuf : public std::streambuf {
+     public:
+      ContentViewStreamBuf(const uint8_t* data, size_t size) {
+        char* begin = const_cast<char*>(reinterpret_cast<const char*>(data));
+        setg(begin, begin, begin + size);
+      }
+
+     protected:
+      pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+        off_type base = 0;
+        if (dir == std::ios_base::cur) {
+          base = gptr() - eback();
+        } else if (dir == std::ios_base::end) {
+          base = egptr() - eback();
+        }
+        return seekpos(pos_type(base + off), which);
+      }
+
+      pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+        if (!(which & std::ios_base::in) || pos < 0 || pos > egptr() - eback()) {
+          return pos_type(off_type(-1));
+        }
+        setg(eback(), eback() + off_type(pos), egptr());
+        return pos;
+      }
+    };
+
+   public:
     uint64_t flow_size_;
     const minifi::aws::s3::PutObjectRequestParameters& options_;
     aws::s3::S3WrapperBase* s3_wrapper_;
@@ -21,6 +21,7 @@
 #include <iomanip>
 #include <random>
 #include <algorithm>
+#include <set>
 
 #include "rapidjson/reader.h"
 #include "rapidjson/writer.h"
@@ -785,16 +786,14 @@ Value expr_replace(const std::vector<Value> &args) {
   return Value(result);
 }
 
-Value expr_replaceFirst(const std::vector<Value> &args) {
-  std::string result = args[0].asString();
-  const std::regex find(args[1].asString());
+Value expr_replaceFirst(const std::vector<Value> &args, const std::regex &find) {
+  const std::string &result = args[0].asString();
   const std::string &replace = args[2].asString();
   return Value(std::regex_replace(result, find, replace, std::regex_constants::format_first_only));
 }
 
-Value expr_replaceAll(const std::vector<Value> &args) {
-  std::string result = args[0].asString();
-  const std::regex find(args[1].asString());
+Value expr_replaceAll(const std::vector<Value> &args, const std::regex &find) {
+  const std::string &result = args[0].asString();
   const std::string &replace = args[2].asString();
   return Value(std::regex_replace(result, find, replace));
 }
@@ -808,26 +807,40 @@ Value expr_replaceNull(const std::vector<Value> &args) {
 }
 
 Value expr_replaceEmpty(const std::vector<Value> &args) {
-  std::string result = args[0].asString();
-  const std::regex find("^[ \n\r\t]*$");
+  static const std::regex find("^[ \n\r\t]*$");
+  const std::string &result = args[0].asString();
   const std::string &replace = args[1].asString();
   return Value(std::regex_replace(result, find, replace));
 }
 
-Value expr_matches(const std::vector<Value> &args) {
+Value expr_matches(const std::vector<Value> &args, const std::regex &expr) {
   const auto &subject = args[0].asString();
-  const std::regex expr = std::regex(args[1].asString());
 
   return Value(std::regex_match(subject.begin(), subject.end(), expr));
 }
 
-Value expr_find(const std::vector<Value> &args) {
+Value expr_find(const std::vector<Value> &args, const std::regex &expr) {
   const auto &subject = args[0].asString();
-  const std::regex expr = std::regex(args[1].asString());
 
   return Value(std::regex_search(subject.begin(), subject.end(), expr));
 }
 
+/**
+ * Compiles the regex of a static argument, so that it is not compiled again by every evaluation.
+ *
+ * @return the compiled regex, or nullptr if the argument is dynamic or not a valid regex (which is then reported by the evaluation)
+ */
+std::shared_ptr<const std::regex> precompile_regex(const Expression &arg) {
+  if (arg.is_dynamic()) {
+    return nullptr;
+  }
+  try {
+    return std::make_shared<const std::regex>(arg(Parameters()).asString());
+  } catch (const std::regex_error &) {
+    return nullptr;
+  }
+}
+
 #endif  // EXPRESSION_LANGUAGE_USE_REGEX
 
 Value expr_trim(const std::vector<Value> &args) {
@@ -940,8 +953,17 @@ Value expr_random(const std::vector<Value> &args) {
   return Value(distribution(generator));
 }
 
-template<Value T(const std::vector<Value> &)>
-Expression make_dynamic_function_incomplete(const std::string &function_name, const std::vector<Expression> &args, std::size_t num_args) {
+/**
+ * Whether the result of the function depends only on its arguments, so that it can be computed
+ * at compile time when all of its arguments are static.
+ */
+bool is_deterministic(const std::string &function_name) {
+  static const std::set<std::string> non_deterministic_functions { "hostname", "resolve_user_id", "ip", "UUID", "random", "now" };
+  return non_deterministic_functions.count(function_name) == 0;
+}
+
+Expression make_dynamic_function_incomplete(const std::string &function_name, const std::vector<Expression> &args, std::size_t num_args,
+                                            const std::function<Value(const std::vector<Value> &)> &fn) {
 
   if (args.size() < num_args) {
     std::stringstream message_ss;
@@ -956,23 +978,64 @@ Expression make_dynamic_function_incomplete(const std::string &function_name, co
       multi_args.emplace_back(*it);
     }
 
-    return args[0].compose_multi([=](const std::vector<Value> &args) -> Value {
-      return T(args);
-    },
-                                 multi_args);
-  } else {
-    return make_dynamic([=](const Parameters &params, const std::vector<Expression> &sub_exprs) -> Value {
-      std::vector<Value> evaluated_args;
+    return args[0].compose_multi(fn, multi_args);
+  }
 
-      for (const auto &arg : args) {
-        evaluated_args.emplace_back(arg(params));
-      }
+  const bool all_static = std::none_of(args.begin(), args.end(), [](const Expression &arg) { return arg.is_dynamic(); });
+  if (!args.empty() && all_static && is_deterministic(function_name)) {
+    std::vector<Value> evaluated_args;
+    evaluated_args.reserve(args.size());
+    for (const auto &arg : args) {
+      evaluated_args.emplace_back(arg(Parameters()));
+    }
+    try {
+      return Expression(fn(evaluated_args));
+    } catch (const std::exception &) {
+      // keep reporting the error at evaluation time
+    }
+  }
+
+  return make_dynamic([args, fn](const Parameters &params, const std::vector<Expression> &sub_exprs) -> Value {
+    std::vector<Value> evaluated_args;
+    evaluated_args.reserve(args.size());
+
+    for (const auto &arg : args) {
+      evaluated_args.emplace_back(arg(params));
+    }
+
+    return fn(evaluated_args);
+  });
+}
+
+template<Value T(const std::vector<Value> &)>
+Expression make_dynamic_function_incomplete(const std::string &function_name, const std::vector<Expression> &args, std::size_t num_args) {
+  return make_dynamic_function_incomplete(function_name, args, num_args, T);
+}
+
+#ifdef EXPRESSION_LANGUAGE_USE_REGEX
 
-      return T(evaluated_args);
+/**
+ * Creates a function whose second argument is a regex. A static regex is compiled only once, here.
+ */
+template<Value T(const std::vector<Value> &, const std::regex &)>
+Expression make_regex_function(const std::string &function_name, const std::vector<Expression> &args, std::size_t num_args) {
+  std::shared_ptr<const std::regex> regex;
+  if (args.size() > 1) {
+    regex = precompile_regex(args[1]);
+  }
+
+  if (regex) {
+    return make_dynamic_function_incomplete(function_name, args, num_args, [regex](const std::vector<Value> &args) -> Value {
+      return T(args, *regex);
     });
   }
+  return make_dynamic_function_incomplete(function_name, args, num_args, [](const std::vector<Value> &args) -> Value {
+    return T(args, std::regex(args[1].asString()));
+  });
 }
 
+#endif  // EXPRESSION_LANGUAGE_USE_REGEX
+
 Value expr_literal(const std::vector<Value> &args) {
   return args[0];
 }
@@ -1178,11 +1241,16 @@ Expression make_allMatchingAttributes(const std::string &function_name, const st
     return Value(all_true);
   });
 
+  std::vector<std::shared_ptr<const std::regex>> regexes;
+  for (const auto &arg : args) {
+    regexes.push_back(precompile_regex(arg));
+  }
+
   result.make_multi([=](const Parameters &params) -> std::vector<Expression> {
     std::vector<Expression> out_exprs;
 
-    for (const auto &arg : args) {
-      const std::regex attr_regex = std::regex(arg(params).asString());
+    for (size_t i = 0; i < args.size(); ++i) {
+      const std::regex attr_regex = regexes[i] ? *regexes[i] : std::regex(args[i](params).asString());
       const auto cur_flow_file = params.flow_file.lock();
       std::map<std::string, std::string> attrs;
 
@@ -1231,11 +1299,16 @@ Expression make_anyMatchingAttribute(const std::string &function_name, const std
     return Value(any_true);
   });
 
+  std::vector<std::shared_ptr<const std::regex>> regexes;
+  for (const auto &arg : args) {
+    regexes.push_back(precompile_regex(arg));
+  }
+
   result.make_multi([=](const Parameters &params) -> std::vector<Expression> {
     std::vector<Expression> out_exprs;
 
-    for (const auto &arg : args) {
-      const std::regex attr_regex = std::regex(arg(params).asString());
+    for (size_t i = 0; i < args.size(); ++i) {
+      const std::regex attr_regex = regexes[i] ? *regexes[i] : std::regex(args[i](params).asString());
       const auto cur_flow_file = params.flow_file.lock();
       std::map<std::string, std::string> attrs;
 
@@ -1458,17 +1531,17 @@ Expression make_dynamic_function(const std::string &function_name, const std::ve
   } else if (function_name == "replace") {
     return make_dynamic_function_incomplete<expr_replace>(function_name, args, 2);
   } else if (function_name == "replaceFirst") {
-    return make_dynamic_function_incomplete<expr_replaceFirst>(function_name, args, 2);
+    return make_regex_function<expr_replaceFirst>(function_name, args, 2);
   } else if (function_name == "replaceAll") {
-    return make_dynamic_function_incomplete<expr_replaceAll>(function_name, args, 2);
+    return make_regex_function<expr_replaceAll>(function_name, args, 2);
   } else if (function_name == "replaceNull") {
     return make_dynamic_function_incomplete<expr_replaceNull>(function_name, args, 1);
   } else if (function_name == "replaceEmpty") {
     return make_dynamic_function_incomplete<expr_replaceEmpty>(function_name, args, 1);
   } else if (function_name == "matches") {
-    return make_dynamic_function_incomplete<expr_matches>(function_name, args, 1);
+    return make_regex_function<expr_matches>(function_name, args, 1);
   } else if (function_name == "find") {
-    return make_dynamic_function_incomplete<expr_find>(function_name, args, 1);
+    return make_regex_function<expr_find>(function_name, args, 1);
   } else if (function_name == "allMatchingAttributes") {
     return make_allMatchingAttributes(function_name, args);
   } else if (function_name == "anyMatchingAttribute") {
@@ -17,6 +17,8 @@
 
 #include "ProcessContextExpr.h"
 #include <memory>
+#include <string>
+
 namespace org {
 namespace apache {
 namespace nifi {
@@ -27,16 +29,8 @@ bool ProcessContextExpr::getProperty(const Property &property, std::string &valu
   if (!property.supportsExpressionLangauge()) {
     return ProcessContext::getProperty(property.getName(), value);
   }
-  auto name = property.getName();
-  if (expressions_.find(name) == expressions_.end()) {
-    std::string expression_str;
-    ProcessContext::getProperty(name, expression_str);
-    logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
-    expressions_.emplace(name, expression::compile(expression_str));
-  }
-
-  minifi::expression::Parameters p(shared_from_this(), flow_file);
-  value = expressions_[name](p).asString();
+  std::call_once(expressions_compiled_, &ProcessContextExpr::compileExpressions, this);
+  value = evaluate(expressions_, property.getName(), false, flow_file);
   return true;
 }
 
@@ -45,16 +39,44 @@ bool ProcessContextExpr::getDynamicProperty(const Property &property, std::strin
   if (!property.supportsExpressionLangauge()) {
     return ProcessContext::getDynamicProperty(property.getName(), value);
   }
-  auto name = property.getName();
-  if (dynamic_property_expressions_.find(name) == dynamic_property_expressions_.end()) {
-    std::string expression_str;
+  std::call_once(expressions_compiled_, &ProcessContextExpr::compileExpressions, this);
+  value = evaluate(dynamic_property_expressions_, property.getName(), true, flow_file);
+  return true;
+}
+
+void ProcessContextExpr::compileExpressions() {
+  const auto processor = std::dynamic_pointer_cast<ConfigurableComponent>(getProcessorNode()->getProcessor());
+  if (processor) {
+    for (const auto &property : processor->getProperties()) {
+      if (property.second.supportsExpressionLangauge()) {
+        expressions_.emplace(property.first, compileExpression(property.first, false));
+      }
+    }
+  }
+  for (const auto &name : getDynamicPropertyKeys()) {
+    dynamic_property_expressions_.emplace(name, compileExpression(name, true));
+  }
+}
+
+expression::Expression ProcessContextExpr::compileExpression(const std::string &name, bool dynamic_property) {
+  std::string expression_str;
+  if (dynamic_property) {
     ProcessContext::getDynamicProperty(name, expression_str);
-    logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
-    dynamic_property_expressions_.emplace(name, expression::compile(expression_str));
+  } else {
+    ProcessContext::getProperty(name, expression_str);
   }
+  logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
+  return expression::compile(expression_str);
+}
+
+std::string ProcessContextExpr::evaluate(const ExpressionTable &expressions, const std::string &name, bool dynamic_property, const std::shared_ptr<FlowFile> &flow_file) {
   minifi::expression::Parameters p(shared_from_this(), flow_file);
-  value = dynamic_property_expressions_[name](p).asString();
-  return true;
+  const auto it = expressions.find(name);
+  if (it != expressions.end()) {
+    return it->second(p).asString();
+  }
+  // the property was added after the tables were compiled, which are never modified
+  return compileExpression(name, dynamic_property)(p).asString();
 }
 
 } /* namespace core */
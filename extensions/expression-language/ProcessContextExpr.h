@@ -17,6 +17,9 @@
 
 #include <ProcessContext.h>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <impl/expression/Expression.h>
 
 namespace org {
@@ -62,9 +65,22 @@ class ProcessContextExpr : public core::ProcessContext {
 
   virtual bool getDynamicProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) override;
  protected:
+  using ExpressionTable = std::unordered_map<std::string, org::apache::nifi::minifi::expression::Expression>;
 
-  std::map<std::string, org::apache::nifi::minifi::expression::Expression> expressions_;
-  std::map<std::string, org::apache::nifi::minifi::expression::Expression> dynamic_property_expressions_;
+  /**
+   * Compiles the expressions of the properties and dynamic properties which are set when the first one is
+   * evaluated. The tables are not modified afterwards, so the concurrent tasks of the processor look up the
+   * expressions without any synchronization.
+   */
+  void compileExpressions();
+
+  org::apache::nifi::minifi::expression::Expression compileExpression(const std::string &name, bool dynamic_property);
+
+  std::string evaluate(const ExpressionTable &expressions, const std::string &name, bool dynamic_property, const std::shared_ptr<FlowFile> &flow_file);
+
+  std::once_flag expressions_compiled_;
+  ExpressionTable expressions_;
+  ExpressionTable dynamic_property_expressions_;
 
  private:
   std::shared_ptr<logging::Logger> logger_;
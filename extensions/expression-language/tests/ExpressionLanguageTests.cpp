@@ -511,6 +511,34 @@ TEST_CASE("Matches 3", "[expressionLanguageMatches3]") {  // NOLINT
   REQUIRE("false" == expr({ flow_file_a }).asString());
 }
 
+TEST_CASE("Matches with a dynamic regex", "[expressionLanguageMatchesDynamicRegex]") {  // NOLINT
+  auto expr = expression::compile("${attr:matches(${pattern})}");
+
+  auto flow_file_a = std::make_shared<core::FlowFile>();
+  flow_file_a->addAttribute("attr", "At:est");
+  flow_file_a->addAttribute("pattern", "^(Ct|Bt|At):.*t$");
+  REQUIRE("true" == expr({ flow_file_a }).asString());
+  flow_file_a->setAttribute("pattern", "^Ct:.*t$");
+  REQUIRE("false" == expr({ flow_file_a }).asString());
+}
+
+TEST_CASE("Matches with an invalid regex fails on evaluation", "[expressionLanguageMatchesInvalidRegex]") {  // NOLINT
+  auto expr = expression::compile("${attr:matches('(Ct|Bt')}");
+
+  auto flow_file_a = std::make_shared<core::FlowFile>();
+  flow_file_a->addAttribute("attr", "Ct");
+  REQUIRE_THROWS(expr({ flow_file_a }));
+}
+
+TEST_CASE("Static function calls are computed at compile time", "[expressionLanguageConstantFolding]") {  // NOLINT
+  auto expr = expression::compile("${literal('abc'):toUpper():append(${literal(1):plus(2)})}");
+  REQUIRE(!expr.is_dynamic());
+  REQUIRE("ABC3" == expr({}).asString());
+
+  auto random_expr = expression::compile("${random():mod(10)}");
+  REQUIRE(random_expr.is_dynamic());
+}
+
 TEST_CASE("Find", "[expressionLanguageFind]") {  // NOLINT
   auto expr = expression::compile("${attr:find('a [Bb]rand [Nn]ew')}");
 
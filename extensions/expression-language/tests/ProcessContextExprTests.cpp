@@ -0,0 +1,85 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TestBase.h"
+#include "ProcessContextExpr.h"
+#include "core/FlowFile.h"
+#include "core/ProcessorNode.h"
+#include <UpdateAttribute.h>
+
+TEST_CASE("ProcessContextExpr evaluates the expressions for concurrent tasks", "[processContextExprConcurrentTasks]") {
+  auto update = std::make_shared<minifi::processors::UpdateAttribute>("UpdateAttribute");
+  update->initialize();
+  update->setDynamicProperty("greeting", "hello ${name}");
+  update->setDynamicProperty("farewell", "bye ${name}");
+  auto node = std::make_shared<core::ProcessorNode>(update);
+  auto repo = std::make_shared<TestRepository>();
+  auto context = std::make_shared<core::ProcessContextExpr>(node, nullptr, repo, repo);
+
+  const auto greeting = core::PropertyBuilder::createProperty("greeting")->supportsExpressionLanguage(true)->build();
+  const auto farewell = core::PropertyBuilder::createProperty("farewell")->supportsExpressionLanguage(true)->build();
+
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> tasks;
+  for (int i = 0; i < 8; ++i) {
+    tasks.emplace_back([&, i] {
+      const std::string name = "task" + std::to_string(i);
+      for (int j = 0; j < 500; ++j) {
+        auto flow_file = std::make_shared<core::FlowFile>();
+        flow_file->addAttribute("name", name);
+        std::string value;
+        if (!context->getDynamicProperty(greeting, value, flow_file) || value != "hello " + name) {
+          ++mismatches;
+        }
+        if (!context->getDynamicProperty(farewell, value, flow_file) || value != "bye " + name) {
+          ++mismatches;
+        }
+      }
+    });
+  }
+  for (auto &task : tasks) {
+    task.join();
+  }
+  REQUIRE(0 == mismatches.load());
+}
+
+TEST_CASE("ProcessContextExpr evaluates the properties set after the expressions were compiled", "[processContextExprLateProperties]") {
+  auto update = std::make_shared<minifi::processors::UpdateAttribute>("UpdateAttribute");
+  update->initialize();
+  update->setDynamicProperty("greeting", "hello ${name}");
+  auto node = std::make_shared<core::ProcessorNode>(update);
+  auto repo = std::make_shared<TestRepository>();
+  auto context = std::make_shared<core::ProcessContextExpr>(node, nullptr, repo, repo);
+
+  auto flow_file = std::make_shared<core::FlowFile>();
+  flow_file->addAttribute("name", "late");
+  const auto greeting = core::PropertyBuilder::createProperty("greeting")->supportsExpressionLanguage(true)->build();
+  std::string value;
+  REQUIRE(context->getDynamicProperty(greeting, value, flow_file));
+  REQUIRE("hello late" == value);
+
+  update->setDynamicProperty("farewell", "bye ${name}");
+  const auto farewell = core::PropertyBuilder::createProperty("farewell")->supportsExpressionLanguage(true)->build();
+  REQUIRE(context->getDynamicProperty(farewell, value, flow_file));
+  REQUIRE("bye late" == value);
+}
@@ -24,8 +24,10 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <utility>
 #include "utils/StringUtils.h"
 #include "utils/RegexUtils.h"
+#include "utils/gsl.h"
 
 namespace org {
 namespace apache {
@@ -40,6 +42,18 @@ HTTPClient::HTTPClient(const std::string &url, const std::shared_ptr<minifi::con
   http_session_ = curl_easy_init();
 }
 
+HTTPClient::HTTPClient(const std::string &url, const std::shared_ptr<minifi::controllers::SSLContextService> ssl_context_service, std::shared_ptr<HTTPConnectionPool> connection_pool)
+    : core::Connectable("HTTPClient"),
+      ssl_context_service_(ssl_context_service),
+      url_(url),
+      connection_pool_(std::move(connection_pool)) {
+  http_session_ = connection_pool_->acquire(HTTPConnectionPool::getKey(url_, ssl_context_service_));
+#if CURL_AT_LEAST_VERSION(7, 47, 0)
+  // negotiate HTTP/2 over TLS where the server supports it, falls back to HTTP/1.1 otherwise
+  curl_easy_setopt(http_session_, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif
+}
+
 HTTPClient::HTTPClient(std::string name, utils::Identifier uuid)
     : core::Connectable(name, uuid) {
   http_session_ = curl_easy_init();
@@ -56,7 +70,12 @@ HTTPClient::~HTTPClient() {
     headers_ = nullptr;
   }
   if (http_session_ != nullptr) {
-    curl_easy_cleanup(http_session_);
+    if (connection_pool_ != nullptr) {
+      // the url might have been changed since the handle was acquired
+      connection_pool_->release(HTTPConnectionPool::getKey(url_, ssl_context_service_), http_session_);
+    } else {
+      curl_easy_cleanup(http_session_);
+    }
     http_session_ = nullptr;
   }
   // forceClose ended up not being the issue in MINIFICPP-667, but leaving here
@@ -190,6 +209,25 @@ void HTTPClient::setUploadCallback(HTTPUploadCallback *callbackObj) {
   curl_easy_setopt(http_session_, CURLOPT_READDATA, static_cast<void*>(callbackObj));
 }
 
+void HTTPClient::setUploadStream(const std::shared_ptr<io::BaseStream> &stream, uint64_t offset, uint64_t size) {
+  logger_->log_debug("Streaming %" PRIu64 " bytes of request body to %s", size, url_);
+  upload_stream_ = {stream, offset, size, 0};
+  if (method_ == "put" || method_ == "PUT") {
+    curl_easy_setopt(http_session_, CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(size));
+  } else {
+    // without a size curl would send the body with chunked encoding
+    curl_easy_setopt(http_session_, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(size));
+  }
+  curl_easy_setopt(http_session_, CURLOPT_READFUNCTION, &HTTPClient::readFromUploadStream);
+  curl_easy_setopt(http_session_, CURLOPT_READDATA, static_cast<void*>(&upload_stream_));
+  curl_easy_setopt(http_session_, CURLOPT_SEEKFUNCTION, &HTTPClient::seekUploadStream);
+  curl_easy_setopt(http_session_, CURLOPT_SEEKDATA, static_cast<void*>(&upload_stream_));
+}
+
+void HTTPClient::setResponseStream(const std::shared_ptr<io::BaseStream> &stream) {
+  response_stream_ = stream;
+}
+
 void HTTPClient::setSeekFunction(HTTPUploadCallback *callbackObj) {
   curl_easy_setopt(http_session_, CURLOPT_SEEKDATA, static_cast<void*>(callbackObj));
   curl_easy_setopt(http_session_, CURLOPT_SEEKFUNCTION, &utils::HTTPRequestResponse::seek_callback);
@@ -244,6 +282,13 @@ void HTTPClient::setUseChunkedEncoding() {
 }
 
 bool HTTPClient::submit() {
+  if (!prepareSubmit()) {
+    return false;
+  }
+  return finishSubmit(curl_easy_perform(http_session_));
+}
+
+bool HTTPClient::prepareSubmit() {
   if (IsNullOrEmpty(url_))
     return false;
 
@@ -270,7 +315,10 @@ bool HTTPClient::submit() {
 
   curl_easy_setopt(http_session_, CURLOPT_URL, url_.c_str());
   logger_->log_debug("Submitting to %s", url_);
-  if (callback == nullptr) {
+  if (response_stream_ != nullptr) {
+    curl_easy_setopt(http_session_, CURLOPT_WRITEFUNCTION, &HTTPClient::writeToResponseStream);
+    curl_easy_setopt(http_session_, CURLOPT_WRITEDATA, static_cast<void*>(response_stream_.get()));
+  } else if (callback == nullptr) {
     content_.ptr = &read_callback_;
     curl_easy_setopt(http_session_, CURLOPT_WRITEFUNCTION, &utils::HTTPRequestResponse::recieve_write);
     curl_easy_setopt(http_session_, CURLOPT_WRITEDATA, static_cast<void*>(&content_));
@@ -289,7 +337,11 @@ bool HTTPClient::submit() {
     logger_->log_debug("Not using keep alive");
     curl_easy_setopt(http_session_, CURLOPT_TCP_KEEPALIVE, 0L);
   }
-  res = curl_easy_perform(http_session_);
+  return true;
+}
+
+bool HTTPClient::finishSubmit(CURLcode result) {
+  res = result;
   if (callback == nullptr) {
     read_callback_.close();
   }
@@ -298,7 +350,7 @@ bool HTTPClient::submit() {
   http_code_ = http_code;
   curl_easy_getinfo(http_session_, CURLINFO_CONTENT_TYPE, &content_type_str_);
   if (res == CURLE_OPERATION_TIMEDOUT) {
-    logger_->log_error("HTTP operation timed out, with absolute timeout %dms\n", absoluteTimeout);
+    logger_->log_error("HTTP operation timed out, with absolute timeout %dms\n", std::max(0, 3 * static_cast<int>(read_timeout_ms_.count())));
   }
   if (res != CURLE_OK) {
     logger_->log_error("curl_easy_perform() failed %s on %s, error code %d\n", curl_easy_strerror(res), url_, res);
@@ -368,6 +420,37 @@ int HTTPClient::onProgress(void *clientp, curl_off_t dltotal, curl_off_t dlnow,
   return 0;
 }
 
+size_t HTTPClient::readFromUploadStream(char *data, size_t size, size_t nmemb, void *upload_stream) {
+  UploadStream &upload = *static_cast<UploadStream*>(upload_stream);
+  const uint64_t len = (std::min)(static_cast<uint64_t>(size * nmemb), upload.size - upload.pos);
+  if (len == 0) {
+    return 0;
+  }
+  const int ret = upload.stream->read(reinterpret_cast<uint8_t*>(data), gsl::narrow<int>(len));
+  if (ret <= 0) {
+    return CURL_READFUNC_ABORT;
+  }
+  upload.pos += ret;
+  return gsl::narrow<size_t>(ret);
+}
+
+int HTTPClient::seekUploadStream(void *upload_stream, curl_off_t offset, int origin) {
+  UploadStream &upload = *static_cast<UploadStream*>(upload_stream);
+  if (origin != SEEK_SET || offset < 0 || static_cast<uint64_t>(offset) > upload.size) {
+    return CURL_SEEKFUNC_CANTSEEK;
+  }
+  upload.stream->seek(upload.offset + offset);
+  upload.pos = offset;
+  return CURL_SEEKFUNC_OK;
+}
+
+size_t HTTPClient::writeToResponseStream(char *data, size_t size, size_t nmemb, void *response_stream) {
+  const size_t len = size * nmemb;
+  io::BaseStream &stream = *static_cast<io::BaseStream*>(response_stream);
+  // returning less than the size of the data aborts the transfer
+  return stream.write(reinterpret_cast<uint8_t*>(data), gsl::narrow<int>(len)) == gsl::narrow<int>(len) ? len : 0;
+}
+
 bool HTTPClient::matches(const std::string &value, const std::string &sregex) {
   if (sregex == ".*")
     return true;
@@ -52,11 +52,13 @@
 #endif
 
 #include "utils/ByteArrayCallback.h"
+#include "io/BaseStream.h"
 #include "controllers/SSLContextService.h"
 #include "core/logging/Logger.h"
 #include "core/logging/LoggerConfiguration.h"
 #include "properties/Configure.h"
 #include "io/validation.h"
+#include "HTTPConnectionPool.h"
 
 namespace org {
 namespace apache {
@@ -80,6 +82,12 @@ class HTTPClient : public BaseHTTPClient, public core::Connectable {
 
   explicit HTTPClient(const std::string &url, const std::shared_ptr<minifi::controllers::SSLContextService> ssl_context_service = nullptr);
 
+  /**
+   * Creates a client whose curl handle, along with its open connections, is taken from the pool
+   * and given back to it once the client is destroyed.
+   */
+  HTTPClient(const std::string &url, const std::shared_ptr<minifi::controllers::SSLContextService> ssl_context_service, std::shared_ptr<HTTPConnectionPool> connection_pool);
+
   ~HTTPClient();
 
   static int debug_callback(CURL *handle, curl_infotype type, char *data, size_t size, void *userptr);
@@ -110,6 +118,22 @@ class HTTPClient : public BaseHTTPClient, public core::Connectable {
 
   virtual void setReadCallback(HTTPReadCallback *callbackObj);
 
+  /**
+   * Streams the request body from the given stream instead of a buffer. The body is read into
+   * the upload buffer of curl as the request is sent, and the stream is sought back to the start
+   * of the body if curl needs to send it again, e.g. when following a redirect.
+   * @param stream stream positioned at the start of the body
+   * @param offset position of the start of the body in the stream
+   * @param size size of the body
+   */
+  void setUploadStream(const std::shared_ptr<io::BaseStream> &stream, uint64_t offset, uint64_t size);
+
+  /**
+   * Writes the response body into the given stream as it is received, instead of buffering it.
+   * getResponseBody() returns an empty body in this case.
+   */
+  void setResponseStream(const std::shared_ptr<io::BaseStream> &stream);
+
   struct curl_slist *build_header_list(std::string regex, const std::map<std::string, std::string> &attributes);
 
   void setContentType(std::string content_type) override;
@@ -234,8 +258,41 @@ class HTTPClient : public BaseHTTPClient, public core::Connectable {
     }
   }
  private:
+  // performs the requests of several clients at once
+  friend class HTTPMultiClient;
+
   static int onProgress(void *client, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
 
+  /**
+   * Sets the options of the handle for the request, before it is performed.
+   * @return false if the request cannot be submitted
+   */
+  bool prepareSubmit();
+
+  /**
+   * Collects the result of the performed request.
+   * @param result result of the transfer
+   * @return true if the transfer succeeded
+   */
+  bool finishSubmit(CURLcode result);
+
+  struct UploadStream {
+    std::shared_ptr<io::BaseStream> stream;
+    uint64_t offset;
+    uint64_t size;
+    uint64_t pos;
+  };
+
+  static size_t readFromUploadStream(char *data, size_t size, size_t nmemb, void *upload_stream);
+
+  static int seekUploadStream(void *upload_stream, curl_off_t offset, int origin);
+
+  static size_t writeToResponseStream(char *data, size_t size, size_t nmemb, void *response_stream);
+
+  UploadStream upload_stream_{nullptr, 0, 0, 0};
+
+  std::shared_ptr<io::BaseStream> response_stream_;
+
   struct Progress{
     std::chrono::steady_clock::time_point last_transferred_;
     curl_off_t uploaded_data_;
@@ -288,6 +345,8 @@ class HTTPClient : public BaseHTTPClient, public core::Connectable {
 
   CURL *http_session_;
 
+  std::shared_ptr<HTTPConnectionPool> connection_pool_;
+
   std::string method_;
 
   std::chrono::milliseconds keep_alive_probe_{-1};
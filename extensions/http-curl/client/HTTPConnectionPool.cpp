@@ -0,0 +1,145 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HTTPConnectionPool.h"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+constexpr size_t HTTPConnectionPool::DEFAULT_MAX_IDLE_CONNECTIONS_PER_HOST;
+
+HTTPConnectionPool::HTTPConnectionPool(size_t max_idle_connections_per_host)
+    : max_idle_connections_per_host_(max_idle_connections_per_host),
+      share_(curl_share_init()) {
+  if (share_ != nullptr) {
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &HTTPConnectionPool::lockShare);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &HTTPConnectionPool::unlockShare);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, static_cast<void*>(this));
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  }
+}
+
+HTTPConnectionPool::~HTTPConnectionPool() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &idle : idle_handles_) {
+    for (CURL *handle : idle.second) {
+      curl_easy_cleanup(handle);
+    }
+  }
+  idle_handles_.clear();
+  // the share can only be cleaned up once none of the handles use it
+  if (share_ != nullptr) {
+    curl_share_cleanup(share_);
+    share_ = nullptr;
+  }
+}
+
+CURL *HTTPConnectionPool::acquire(const std::string &key) {
+  CURL *handle = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = idle_handles_.find(key);
+    if (it != idle_handles_.end() && !it->second.empty()) {
+      handle = it->second.back();
+      it->second.pop_back();
+    }
+  }
+  if (handle != nullptr) {
+    logger_->log_trace("Reusing connection to %s", key);
+    return handle;
+  }
+  logger_->log_trace("Creating connection to %s", key);
+  handle = curl_easy_init();
+  if (handle != nullptr && share_ != nullptr) {
+    curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+  }
+  return handle;
+}
+
+void HTTPConnectionPool::release(const std::string &key, CURL *handle) {
+  if (handle == nullptr) {
+    return;
+  }
+  // resetting the options keeps the live connections and the caches of the handle
+  curl_easy_reset(handle);
+  if (share_ != nullptr) {
+    curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &idle = idle_handles_[key];
+    if (idle.size() < max_idle_connections_per_host_) {
+      idle.push_back(handle);
+      return;
+    }
+  }
+  curl_easy_cleanup(handle);
+}
+
+size_t HTTPConnectionPool::getIdleCount(const std::string &key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = idle_handles_.find(key);
+  return it != idle_handles_.end() ? it->second.size() : 0;
+}
+
+std::string HTTPConnectionPool::getKey(const std::string &url, const std::shared_ptr<minifi::controllers::SSLContextService> &ssl_context_service) {
+  const auto scheme_end = url.find("://");
+  std::string scheme = scheme_end != std::string::npos ? url.substr(0, scheme_end) : "http";
+  const size_t authority_begin = scheme_end != std::string::npos ? scheme_end + 3 : 0;
+  const size_t authority_end = (std::min)(url.find_first_of("/?#", authority_begin), url.size());
+  std::string authority = url.substr(authority_begin, authority_end - authority_begin);
+  const auto user_info_end = authority.rfind('@');
+  if (user_info_end != std::string::npos) {
+    authority.erase(0, user_info_end + 1);
+  }
+  std::transform(scheme.begin(), scheme.end(), scheme.begin(), ::tolower);
+  std::transform(authority.begin(), authority.end(), authority.begin(), ::tolower);
+
+  // the port may only follow the host, which is enclosed in brackets if it is an IPv6 address
+  const auto host_end = authority.rfind(']');
+  if (authority.find(':', host_end != std::string::npos ? host_end : 0) == std::string::npos) {
+    authority += scheme == "https" ? ":443" : ":80";
+  }
+
+  std::string key = scheme + "://" + authority;
+  if (ssl_context_service != nullptr) {
+    key += "#" + ssl_context_service->getUUIDStr();
+  }
+  return key;
+}
+
+void HTTPConnectionPool::lockShare(CURL* /*handle*/, curl_lock_data data, curl_lock_access /*access*/, void *pool) {
+  static_cast<HTTPConnectionPool*>(pool)->share_mutexes_.at(data).lock();
+}
+
+void HTTPConnectionPool::unlockShare(CURL* /*handle*/, curl_lock_data data, void *pool) {
+  static_cast<HTTPConnectionPool*>(pool)->share_mutexes_.at(data).unlock();
+}
+
+}  // namespace utils
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
@@ -0,0 +1,119 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_HTTP_CURL_CLIENT_HTTPCONNECTIONPOOL_H_
+#define EXTENSIONS_HTTP_CURL_CLIENT_HTTPCONNECTIONPOOL_H_
+
+#ifdef WIN32
+#define CURL_STATICLIB
+#endif
+#include <curl/curl.h>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "controllers/SSLContextService.h"
+#include "core/logging/Logger.h"
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+/**
+ * Purpose and Justification: Every curl handle keeps a cache of the connections it has opened. Creating
+ * a new handle for each request therefore pays the TCP and TLS handshakes again, even when talking to
+ * the same endpoint. The pool keeps the handles of finished requests, keyed by scheme, host, port and
+ * SSL context, and hands them out to the next request to that endpoint, so that its connection is kept
+ * alive and reused.
+ *
+ * The handles of the pool also share their DNS and TLS session caches, so even new connections can
+ * skip the name lookup and resume a previous TLS session.
+ */
+class HTTPConnectionPool {
+ public:
+  static constexpr size_t DEFAULT_MAX_IDLE_CONNECTIONS_PER_HOST = 5;
+
+  /**
+   * @param max_idle_connections_per_host number of idle handles kept for an endpoint,
+   * 0 disables the pooling
+   */
+  explicit HTTPConnectionPool(size_t max_idle_connections_per_host = DEFAULT_MAX_IDLE_CONNECTIONS_PER_HOST);
+
+  HTTPConnectionPool(const HTTPConnectionPool&) = delete;
+  HTTPConnectionPool& operator=(const HTTPConnectionPool&) = delete;
+
+  ~HTTPConnectionPool();
+
+  /**
+   * Returns an idle handle that was last used for the same endpoint, or a new one
+   * if there is none. The handle is in its initial state apart from the shared caches.
+   * @param key endpoint key, see getKey
+   */
+  CURL *acquire(const std::string &key);
+
+  /**
+   * Gives back a handle to the pool. The handle is cleaned up if the pool
+   * already holds the maximum number of idle handles for the endpoint.
+   * @param key endpoint key of the last request of the handle
+   */
+  void release(const std::string &key, CURL *handle);
+
+  /**
+   * Builds the key of the endpoint of the given url: its scheme, host and
+   * port, along with the SSL context used to connect to it.
+   */
+  static std::string getKey(const std::string &url, const std::shared_ptr<minifi::controllers::SSLContextService> &ssl_context_service);
+
+  size_t getMaxIdleConnectionsPerHost() const {
+    return max_idle_connections_per_host_;
+  }
+
+  /**
+   * Returns the number of idle handles held for the endpoint.
+   */
+  size_t getIdleCount(const std::string &key) const;
+
+ private:
+  static void lockShare(CURL *handle, curl_lock_data data, curl_lock_access access, void *pool);
+
+  static void unlockShare(CURL *handle, curl_lock_data data, void *pool);
+
+  const size_t max_idle_connections_per_host_;
+
+  mutable std::mutex mutex_;
+  std::map<std::string, std::vector<CURL*>> idle_handles_;
+
+  CURLSH *share_;
+  std::array<std::mutex, CURL_LOCK_DATA_LAST> share_mutexes_;
+
+  std::shared_ptr<logging::Logger> logger_{logging::LoggerFactory<HTTPConnectionPool>::getLogger()};
+};
+
+}  // namespace utils
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // EXTENSIONS_HTTP_CURL_CLIENT_HTTPCONNECTIONPOOL_H_
@@ -0,0 +1,97 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HTTPMultiClient.h"
+
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+HTTPMultiClient::HTTPMultiClient()
+    : multi_handle_(curl_multi_init()) {
+}
+
+HTTPMultiClient::~HTTPMultiClient() {
+  // the handles belong to their clients, they are only detached from the multi handle
+  for (const auto &client : clients_) {
+    curl_multi_remove_handle(multi_handle_, client.first);
+  }
+  clients_.clear();
+  if (multi_handle_ != nullptr) {
+    curl_multi_cleanup(multi_handle_);
+    multi_handle_ = nullptr;
+  }
+}
+
+bool HTTPMultiClient::add(HTTPClient *client) {
+  if (multi_handle_ == nullptr || client->http_session_ == nullptr || !client->prepareSubmit()) {
+    return false;
+  }
+  CURLMcode result = curl_multi_add_handle(multi_handle_, client->http_session_);
+  if (result != CURLM_OK) {
+    logger_->log_error("curl_multi_add_handle() failed %s on %s", curl_multi_strerror(result), client->getURL());
+    return false;
+  }
+  clients_[client->http_session_] = client;
+  return true;
+}
+
+std::vector<HTTPClient*> HTTPMultiClient::perform(std::chrono::milliseconds max_wait) {
+  std::vector<HTTPClient*> completed;
+  if (clients_.empty()) {
+    return completed;
+  }
+
+  int running = 0;
+  CURLMcode result = curl_multi_perform(multi_handle_, &running);
+  if (result != CURLM_OK) {
+    logger_->log_error("curl_multi_perform() failed %s", curl_multi_strerror(result));
+  }
+
+  int queued = 0;
+  while (CURLMsg *message = curl_multi_info_read(multi_handle_, &queued)) {
+    if (message->msg != CURLMSG_DONE) {
+      continue;
+    }
+    CURL *handle = message->easy_handle;
+    // the result has to be read before the handle is removed, which invalidates the message
+    CURLcode transfer_result = message->data.result;
+    curl_multi_remove_handle(multi_handle_, handle);
+    auto it = clients_.find(handle);
+    if (it == clients_.end()) {
+      continue;
+    }
+    it->second->finishSubmit(transfer_result);
+    completed.push_back(it->second);
+    clients_.erase(it);
+  }
+
+  if (completed.empty() && running > 0) {
+    curl_multi_wait(multi_handle_, nullptr, 0, static_cast<int>(max_wait.count()), nullptr);
+  }
+  return completed;
+}
+
+}  // namespace utils
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
@@ -0,0 +1,93 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_HTTP_CURL_CLIENT_HTTPMULTICLIENT_H_
+#define EXTENSIONS_HTTP_CURL_CLIENT_HTTPMULTICLIENT_H_
+
+#ifdef WIN32
+#define CURL_STATICLIB
+#endif
+#include <curl/curl.h>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "HTTPClient.h"
+#include "core/logging/Logger.h"
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+/**
+ * Purpose and Justification: HTTPClient::submit blocks the calling thread until the request is complete,
+ * so keeping several requests in flight needs as many threads. The multi client performs the requests of
+ * several clients at once from a single thread, through a curl multi handle. The requests also share the
+ * connections of the multi handle, and are multiplexed over a single connection where HTTP/2 is negotiated.
+ *
+ * The clients must outlive the multi client, or be removed from it by completing their requests.
+ */
+class HTTPMultiClient {
+ public:
+  HTTPMultiClient();
+
+  HTTPMultiClient(const HTTPMultiClient&) = delete;
+  HTTPMultiClient& operator=(const HTTPMultiClient&) = delete;
+
+  ~HTTPMultiClient();
+
+  /**
+   * Starts the request of the client, which must be configured the same way as for HTTPClient::submit.
+   * @return false if the request cannot be submitted
+   */
+  bool add(HTTPClient *client);
+
+  /**
+   * Transfers the data of the requests that are ready, and waits for further activity for at most
+   * max_wait if none of the requests completed.
+   * @return the clients whose requests completed, their results are available through the getters
+   * of HTTPClient, getResponseResult being CURLE_OK where submit would have returned true
+   */
+  std::vector<HTTPClient*> perform(std::chrono::milliseconds max_wait);
+
+  /**
+   * Returns the number of requests in flight.
+   */
+  size_t size() const {
+    return clients_.size();
+  }
+
+ private:
+  CURLM *multi_handle_;
+
+  std::map<CURL*, HTTPClient*> clients_;
+
+  std::shared_ptr<logging::Logger> logger_{logging::LoggerFactory<HTTPMultiClient>::getLogger()};
+};
+
+}  // namespace utils
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // EXTENSIONS_HTTP_CURL_CLIENT_HTTPMULTICLIENT_H_
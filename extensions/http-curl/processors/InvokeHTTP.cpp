@@ -29,6 +29,7 @@
 #include <cinttypes>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <map>
@@ -45,6 +46,7 @@
 #include "io/BufferStream.h"
 #include "io/StreamFactory.h"
 #include "ResourceClaim.h"
+#include "utils/GeneralUtils.h"
 #include "utils/StringUtils.h"
 
 namespace org {
@@ -53,6 +55,28 @@ namespace nifi {
 namespace minifi {
 namespace processors {
 
+namespace {
+
+/**
+ * Runs a function on the content stream of a flowfile.
+ */
+class StreamCallback : public InputStreamCallback, public OutputStreamCallback {
+ public:
+  explicit StreamCallback(std::function<void(const std::shared_ptr<io::BaseStream>&)> function)
+      : function_(std::move(function)) {
+  }
+
+  int64_t process(const std::shared_ptr<io::BaseStream> &stream) override {
+    function_(stream);
+    return 0;
+  }
+
+ private:
+  std::function<void(const std::shared_ptr<io::BaseStream>&)> function_;
+};
+
+}  // namespace
+
 const char *InvokeHTTP::ProcessorName = "InvokeHTTP";
 std::string InvokeHTTP::DefaultContentType = "application/octet-stream";
 
@@ -109,6 +133,18 @@ core::Property InvokeHTTP::AlwaysOutputResponse("Always Output Response", "Will
                                                 "false");
 core::Property InvokeHTTP::PenalizeOnNoRetry("Penalize on \"No Retry\"", "Enabling this property will penalize FlowFiles that are routed to the \"No Retry\" relationship.", "false");
 
+core::Property InvokeHTTP::MaxIdleConnections(
+    core::PropertyBuilder::createProperty("max-idle-connections", "Max Idle Connections")->withDescription("The maximum number of idle connections kept open to the "
+                                                                                  "remote host for reuse by later requests. Set to 0 to open a new connection for every request.")
+        ->isRequired(false)->withDefaultValue<uint64_t>(utils::HTTPConnectionPool::DEFAULT_MAX_IDLE_CONNECTIONS_PER_HOST)->build());
+
+core::Property InvokeHTTP::MaxConcurrentRequests(
+    core::PropertyBuilder::createProperty("max-concurrent-requests", "Max Concurrent Requests")->withDescription("The maximum number of requests a single task keeps in flight. "
+                                                                                  "With more than 1, the task takes new FlowFiles as the earlier requests complete, up to 4 times "
+                                                                                  "this number of FlowFiles per task, and the response bodies are held in memory until their "
+                                                                                  "requests complete.")
+        ->isRequired(false)->withDefaultValue<uint64_t>(1)->build());
+
 core::Property InvokeHTTP::DisablePeerVerification("Disable Peer Verification", "Disables peer verification for the SSL session", "false");
 const char* InvokeHTTP::STATUS_CODE = "invokehttp.status.code";
 const char* InvokeHTTP::STATUS_MESSAGE = "invokehttp.status.message";
@@ -153,6 +189,8 @@ void InvokeHTTP::initialize() {
   properties.insert(SendBody);
   properties.insert(DisablePeerVerification);
   properties.insert(AlwaysOutputResponse);
+  properties.insert(MaxIdleConnections);
+  properties.insert(MaxConcurrentRequests);
 
   setSupportedProperties(properties);
   // Set the supported relationships
@@ -167,6 +205,18 @@ bool getTimeMSFromString(const std::string& propertyName, uint64_t& valInt) {
 }
 
 void InvokeHTTP::onSchedule(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) {
+  uint64_t max_idle_connections = utils::HTTPConnectionPool::DEFAULT_MAX_IDLE_CONNECTIONS_PER_HOST;
+  if (!context->getProperty(MaxIdleConnections.getName(), max_idle_connections)) {
+    logger_->log_debug("%s attribute is missing, so default value of %s will be used", MaxIdleConnections.getName(), MaxIdleConnections.getValue());
+  }
+  connection_pool_ = std::make_shared<utils::HTTPConnectionPool>(max_idle_connections);
+
+  uint64_t max_concurrent_requests = 1;
+  if (!context->getProperty(MaxConcurrentRequests.getName(), max_concurrent_requests)) {
+    logger_->log_debug("%s attribute is missing, so default value of %s will be used", MaxConcurrentRequests.getName(), MaxConcurrentRequests.getValue());
+  }
+  max_concurrent_requests_ = (std::max)(max_concurrent_requests, uint64_t{1});
+
   if (!context->getProperty(Method.getName(), method_)) {
     logger_->log_debug("%s attribute is missing, so default value of %s will be used", Method.getName(), Method.getValue());
     return;
@@ -270,9 +320,12 @@ bool InvokeHTTP::emitFlowFile(const std::string &method) {
 }
 
 void InvokeHTTP::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
-  auto flowFile = session->get();
+  if (max_concurrent_requests_ > 1) {
+    onTriggerConcurrently(context, session);
+    return;
+  }
 
-  std::string url = url_;
+  auto flowFile = session->get();
 
   if (flowFile == nullptr) {
     if (!emitFlowFile(method_)) {
@@ -292,13 +345,141 @@ void InvokeHTTP::onTrigger(const std::shared_ptr<core::ProcessContext> &context,
   // create a transaction id
   std::string tx_id = generateId();
 
-  // Note: callback must be declared before callbackObj so that they are destructed in the correct order
-  std::unique_ptr<utils::ByteInputCallBack> callback = nullptr;
-  std::unique_ptr<utils::HTTPUploadCallback> callbackObj = nullptr;
+  utils::HTTPClient client(url_, ssl_context_service_, connection_pool_);
+
+  bool send_body = prepareRequest(client, flowFile);
+
+  bool putToAttribute = !IsNullOrEmpty(put_attribute_name_);
+
+  // the request body is read from the content of the flowfile and the response body is written
+  // into the content of the response flowfile while the request is performed, so neither of them is buffered
+  std::shared_ptr<core::FlowFile> response_flow = putToAttribute ? nullptr : session->create(flowFile);
+  bool submitted = false;
+  StreamCallback receive([&](const std::shared_ptr<io::BaseStream> &response_stream) {
+    client.setResponseStream(response_stream);
+    submitted = client.submit();
+  });
+  StreamCallback send([&](const std::shared_ptr<io::BaseStream> &request_stream) {
+    client.setUploadStream(request_stream, flowFile->getOffset(), flowFile->getSize());
+    if (response_flow != nullptr) {
+      session->write(response_flow, &receive);
+    } else {
+      submitted = client.submit();
+    }
+  });
+
+  logger_->log_trace("InvokeHTTP -- curl performed");
+  if (send_body) {
+    session->read(flowFile, &send);
+  } else if (response_flow != nullptr) {
+    session->write(response_flow, &receive);
+  } else {
+    submitted = client.submit();
+  }
+
+  handleResponse(client, submitted, tx_id, flowFile, response_flow, session, context);
+}
+
+void InvokeHTTP::onTriggerConcurrently(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
+  struct Request {
+    std::shared_ptr<core::FlowFile> flow_file;
+    std::string tx_id;
+    std::unique_ptr<utils::HTTPClient> client;
+    std::shared_ptr<io::BufferStream> response_body;
+  };
+
+  // the trigger stops taking flowfiles after this many requests per slot, so that the session commits
+  // the routed flowfiles regularly even while the input keeps coming
+  static const uint64_t MAX_REQUESTS_PER_SLOT = 4;
+  const uint64_t max_requests = max_concurrent_requests_ * MAX_REQUESTS_PER_SLOT;
+
+  // the multi client is declared after the requests, so that it detaches their handles before they are destroyed
+  std::map<utils::HTTPClient*, Request> requests;
+  std::unique_ptr<utils::HTTPMultiClient> multi_client = acquireMultiClient();
+
+  bool putToAttribute = !IsNullOrEmpty(put_attribute_name_);
+  bool input_available = true;
+  size_t created = 0;
+  size_t started = 0;
+
+  do {
+    // new flowfiles are taken as the slots of the completed requests free up
+    while (input_available && started < max_requests && requests.size() < max_concurrent_requests_ && isRunning()) {
+      auto flowFile = session->get();
+      if (flowFile == nullptr) {
+        if (emitFlowFile(method_) || created == max_concurrent_requests_) {
+          input_available = false;
+          break;
+        }
+        // without input a trigger sends as many requests as it has slots, instead of a single one
+        flowFile = session->create();
+        ++created;
+      }
+      ++started;
+
+      Request request{flowFile, generateId(), utils::make_unique<utils::HTTPClient>(url_, ssl_context_service_, connection_pool_), nullptr};
+      if (prepareRequest(*request.client, flowFile)) {
+        // the content stream is kept open until the request completes
+        StreamCallback send([&](const std::shared_ptr<io::BaseStream> &request_stream) {
+          request.client->setUploadStream(request_stream, flowFile->getOffset(), flowFile->getSize());
+        });
+        session->read(flowFile, &send);
+      }
+      if (!putToAttribute) {
+        // the response flowfile can only be written once its request completes, the body is collected until then
+        request.response_body = std::make_shared<io::BufferStream>();
+        request.client->setResponseStream(request.response_body);
+      }
+
+      if (!multi_client->add(request.client.get())) {
+        handleResponse(*request.client, false, request.tx_id, flowFile, nullptr, session, context);
+        continue;
+      }
+      utils::HTTPClient *client = request.client.get();
+      requests.emplace(client, std::move(request));
+    }
+
+    for (utils::HTTPClient *client : multi_client->perform(std::chrono::milliseconds(100))) {
+      auto it = requests.find(client);
+      Request &request = it->second;
+      bool submitted = client->getResponseResult() == CURLE_OK;
+      std::shared_ptr<core::FlowFile> response_flow = nullptr;
+      if (submitted && request.response_body != nullptr && client->getResponseCode() / 100 == 2) {
+        response_flow = session->create(request.flow_file);
+        session->importFrom(*request.response_body, response_flow);
+      }
+      handleResponse(*client, submitted, request.tx_id, request.flow_file, response_flow, session, context);
+      requests.erase(it);
+    }
+  } while (!requests.empty());
+  releaseMultiClient(std::move(multi_client));
+
+  if (started == 0) {
+    logger_->log_debug("Exiting because method is %s and there is no flowfile available to execute it, yielding", method_);
+    yield();
+  } else {
+    logger_->log_debug("InvokeHTTP -- completed %zu requests to %s", started, url_);
+  }
+}
+
+std::unique_ptr<utils::HTTPMultiClient> InvokeHTTP::acquireMultiClient() {
+  {
+    std::lock_guard<std::mutex> lock(multi_clients_mutex_);
+    if (!idle_multi_clients_.empty()) {
+      std::unique_ptr<utils::HTTPMultiClient> multi_client = std::move(idle_multi_clients_.back());
+      idle_multi_clients_.pop_back();
+      return multi_client;
+    }
+  }
+  return utils::make_unique<utils::HTTPMultiClient>();
+}
 
-  // Client declared after the callbacks to make sure the callbacks are still available when the client is destructed
-  utils::HTTPClient client(url_, ssl_context_service_);
+void InvokeHTTP::releaseMultiClient(std::unique_ptr<utils::HTTPMultiClient> multi_client) {
+  std::lock_guard<std::mutex> lock(multi_clients_mutex_);
+  idle_multi_clients_.push_back(std::move(multi_client));
+}
 
+bool InvokeHTTP::prepareRequest(utils::HTTPClient &client, const std::shared_ptr<core::FlowFile> &flowFile) {
   client.initialize(method_);
   client.setConnectionTimeout(connect_timeout_ms_);
   client.setReadTimeout(read_timeout_ms_);
@@ -318,39 +499,32 @@ void InvokeHTTP::onTrigger(const std::shared_ptr<core::ProcessContext> &context,
 
   client.setHTTPProxy(proxy_);
 
+  bool send_body = false;
   if (emitFlowFile(method_)) {
-    logger_->log_trace("InvokeHTTP -- reading flowfile");
-    std::shared_ptr<ResourceClaim> claim = flowFile->getResourceClaim();
-    if (claim) {
-      callback = std::unique_ptr<utils::ByteInputCallBack>(new utils::ByteInputCallBack());
-      session->read(flowFile, callback.get());
-      callbackObj = std::unique_ptr<utils::HTTPUploadCallback>(new utils::HTTPUploadCallback);
-      callbackObj->ptr = callback.get();
-      callbackObj->pos = 0;
-      logger_->log_trace("InvokeHTTP -- Setting callback, size is %d", callback->getBufferSize());
+    if (flowFile->getResourceClaim()) {
+      send_body = true;
+      logger_->log_trace("InvokeHTTP -- streaming flowfile, size is %" PRIu64, flowFile->getSize());
       if (!use_chunked_encoding_) {
         client.appendHeader("Content-Length", std::to_string(flowFile->getSize()));
       }
-      client.setUploadCallback(callbackObj.get());
-      client.setSeekFunction(callbackObj.get());
     } else {
       logger_->log_error("InvokeHTTP -- no resource claim");
     }
-
   } else {
     logger_->log_trace("InvokeHTTP -- Not emitting flowfile to HTTP Server");
   }
 
   // append all headers
   client.build_header_list(attribute_to_send_regex_, flowFile->getAttributes());
+  return send_body;
+}
 
-  logger_->log_trace("InvokeHTTP -- curl performed");
-  if (client.submit()) {
+void InvokeHTTP::handleResponse(utils::HTTPClient &client, bool submitted, const std::string &tx_id, const std::shared_ptr<core::FlowFile> &flowFile,
+                                std::shared_ptr<core::FlowFile> response_flow, const std::shared_ptr<core::ProcessSession> &session,
+                                const std::shared_ptr<core::ProcessContext> &context) {
+  if (submitted) {
     logger_->log_trace("InvokeHTTP -- curl successful");
 
-    bool putToAttribute = !IsNullOrEmpty(put_attribute_name_);
-
-    const std::vector<char> &response_body = client.getResponseBody();
     const std::vector<std::string> &response_headers = client.getHeaders();
 
     int64_t http_code = client.getResponseCode();
@@ -362,32 +536,30 @@ void InvokeHTTP::onTrigger(const std::shared_ptr<core::ProcessContext> &context,
     flowFile->addAttribute(TRANSACTION_ID, tx_id);
 
     bool isSuccess = (static_cast<int32_t>(http_code / 100) == 2);
-    bool output_body_to_content = isSuccess && !putToAttribute;
 
     logger_->log_debug("isSuccess: %d, response code %" PRId64, isSuccess, http_code);
-    std::shared_ptr<core::FlowFile> response_flow = nullptr;
 
-    if (output_body_to_content) {
-      if (flowFile != nullptr) {
-        response_flow = session->create(flowFile);
-      } else {
-        response_flow = session->create();
-      }
+    if (response_flow != nullptr && !isSuccess) {
+      // the response body is only output for successful requests
+      session->remove(response_flow);
+      response_flow = nullptr;
+    }
 
+    if (response_flow != nullptr) {
       // if content type isn't returned we should return application/octet-stream
       // as per RFC 2046 -- 4.5.1
       response_flow->addAttribute(core::SpecialFlowAttribute::MIME_TYPE, content_type ? std::string(content_type) : DefaultContentType);
       response_flow->addAttribute(STATUS_CODE, std::to_string(http_code));
       if (!response_headers.empty())
         response_flow->addAttribute(STATUS_MESSAGE, response_headers.at(0));
-      response_flow->addAttribute(REQUEST_URL, url);
+      response_flow->addAttribute(REQUEST_URL, url_);
       response_flow->addAttribute(TRANSACTION_ID, tx_id);
-      io::BufferStream stream((const uint8_t*) response_body.data(), response_body.size());
-      // need an import from the data stream.
-      session->importFrom(stream, response_flow);
     }
     route(flowFile, response_flow, session, context, isSuccess, http_code);
   } else {
+    if (response_flow != nullptr) {
+      session->remove(response_flow);
+    }
     session->penalize(flowFile);
     session->transfer(flowFile, RelFailure);
   }
@@ -20,7 +20,9 @@
 #define __INVOKE_HTTP_H__
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <curl/curl.h>
 #include "utils/ByteArrayCallback.h"
@@ -34,6 +36,8 @@
 #include "core/logging/LoggerConfiguration.h"
 #include "utils/Id.h"
 #include "../client/HTTPClient.h"
+#include "../client/HTTPConnectionPool.h"
+#include "../client/HTTPMultiClient.h"
 
 namespace org {
 namespace apache {
@@ -80,6 +84,10 @@ class InvokeHTTP : public core::Processor {
 
   static core::Property PenalizeOnNoRetry;
 
+  static core::Property MaxIdleConnections;
+
+  static core::Property MaxConcurrentRequests;
+
   static const char* STATUS_CODE;
   static const char* STATUS_MESSAGE;
   static const char* RESPONSE_BODY;
@@ -113,6 +121,38 @@ class InvokeHTTP : public core::Processor {
    */
   std::string generateId();
 
+  /**
+   * Keeps up to max_concurrent_requests_ requests in flight from the thread of the trigger, until
+   * there are no more flowfiles to send or a bounded number of requests have been started. The routed
+   * flowfiles are committed together with the session.
+   */
+  void onTriggerConcurrently(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session);
+
+  /**
+   * Returns a multi client kept from an earlier trigger, along with its connections, or a new one.
+   */
+  std::unique_ptr<utils::HTTPMultiClient> acquireMultiClient();
+
+  /**
+   * Keeps the multi client, which has no requests in flight, for the next trigger.
+   */
+  void releaseMultiClient(std::unique_ptr<utils::HTTPMultiClient> multi_client);
+
+  /**
+   * Configures the client for the request of the flowfile.
+   * @return whether the content of the flowfile is to be sent as the request body
+   */
+  bool prepareRequest(utils::HTTPClient &client, const std::shared_ptr<core::FlowFile> &flowFile);
+
+  /**
+   * Adds the attributes of the response to the flowfiles and routes them.
+   * @param submitted whether the request was performed
+   * @param response_flow flowfile holding the response body, if any
+   */
+  void handleResponse(utils::HTTPClient &client, bool submitted, const std::string &tx_id, const std::shared_ptr<core::FlowFile> &flowFile,
+                      std::shared_ptr<core::FlowFile> response_flow, const std::shared_ptr<core::ProcessSession> &session,
+                      const std::shared_ptr<core::ProcessContext> &context);
+
   /**
    * Routes the flowfile to the proper destination
    * @param request request flow file record
@@ -158,6 +198,13 @@ class InvokeHTTP : public core::Processor {
   // disable peer verification ( makes susceptible for MITM attacks )
   bool disable_peer_verification_{false};
   utils::HTTPProxy proxy_;
+  // keeps the connections of finished requests alive for the next ones
+  std::shared_ptr<utils::HTTPConnectionPool> connection_pool_;
+  // number of requests a task keeps in flight
+  uint64_t max_concurrent_requests_{1};
+  // multi clients of the finished triggers, one is taken by each concurrent task
+  std::mutex multi_clients_mutex_;
+  std::vector<std::unique_ptr<utils::HTTPMultiClient>> idle_multi_clients_;
 
  private:
   std::shared_ptr<logging::Logger> logger_{logging::LoggerFactory<InvokeHTTP>::getLogger()};
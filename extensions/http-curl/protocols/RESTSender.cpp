@@ -25,7 +25,10 @@
 #include <map>
 #include <string>
 #include <vector>
+#include "io/BufferStream.h"
+#include "io/ZlibStream.h"
 #include "utils/file/FileUtils.h"
+#include "utils/gsl.h"
 #include "utils/StringUtils.h"
 #include "utils/file/FileManager.h"
 #include "utils/FileOutputCallback.h"
@@ -56,6 +59,10 @@ void RESTSender::initialize(core::controller::ControllerServiceProvider* control
     }
     configure->get("nifi.c2.rest.heartbeat.minimize.updates", "c2.rest.heartbeat.minimize.updates", update_str);
     utils::StringUtils::StringToBool(update_str, minimize_updates_);
+    std::string compression_str;
+    if (configure->get("nifi.c2.rest.request.compression", "c2.rest.request.compression", compression_str)) {
+      gzip_requests_ = utils::StringUtils::equalsIgnoreCase(utils::StringUtils::trim(compression_str), "gzip");
+    }
   }
   logger_->log_debug("Submitting to %s", rest_uri_);
 }
@@ -82,6 +89,25 @@ void RESTSender::update(const std::shared_ptr<Configure> &configure) {
   configure->get("nifi.c2.rest.url.ack", "c2.rest.url.ack", url);
 }
 
+bool RESTSender::gzipPayload(const std::string &payload, std::string &compressed) {
+  io::BufferStream output;
+  {
+    io::ZlibCompressStream compressor(gsl::make_not_null(&output));
+    const int size = gsl::narrow<int>(payload.size());
+    if (compressor.write(reinterpret_cast<const uint8_t*>(payload.data()), size) != size) {
+      logger_->log_warn("Failed to compress the C2 payload, it is sent uncompressed");
+      return false;
+    }
+    compressor.close();
+    if (!compressor.isFinished()) {
+      logger_->log_warn("Failed to finish compressing the C2 payload, it is sent uncompressed");
+      return false;
+    }
+  }
+  compressed.assign(reinterpret_cast<const char*>(output.getBuffer()), output.size());
+  return true;
+}
+
 void RESTSender::setSecurityContext(utils::HTTPClient &client, const std::string &type, const std::string &url) {
   // only use the SSL Context if we have a secure URL.
   auto generatedService = std::make_shared<minifi::controllers::SSLContextService>("Service", configuration_);
@@ -110,7 +136,13 @@ const C2Payload RESTSender::sendPayload(const std::string url, const Direction d
   if (direction == Direction::TRANSMIT) {
     input = std::unique_ptr<utils::ByteInputCallBack>(new utils::ByteInputCallBack());
     callback = std::unique_ptr<utils::HTTPUploadCallback>(new utils::HTTPUploadCallback());
-    input->write(outputConfig);
+    std::string compressed;
+    if (gzip_requests_ && gzipPayload(outputConfig, compressed)) {
+      input->write(compressed);
+      client.appendHeader("Content-Encoding", "gzip");
+    } else {
+      input->write(outputConfig);
+    }
     callback->ptr = input.get();
     callback->pos = 0;
     client.set_request_method("POST");
@@ -118,7 +150,7 @@ const C2Payload RESTSender::sendPayload(const std::string url, const Direction d
       setSecurityContext(client, "POST", url);
     }
     client.setUploadCallback(callback.get());
-    client.setPostSize(outputConfig.size());
+    client.setPostSize(input->getBufferSize());
   } else {
     // we do not need to set the upload callback
     // since we are not uploading anything on a get
@@ -70,10 +70,20 @@ class RESTSender : public RESTProtocol, public C2Protocol {
    */
   void setSecurityContext(utils::HTTPClient &client,const std::string &type, const std::string &url);
 
+  /**
+   * Compresses the payload with gzip.
+   * @param payload serialized payload
+   * @param compressed receives the compressed payload
+   * @return false if the payload could not be compressed
+   */
+  bool gzipPayload(const std::string &payload, std::string &compressed);
+
   std::shared_ptr<minifi::controllers::SSLContextService> ssl_context_service_;
 
   std::string rest_uri_;
   std::string ack_uri_;
+  // compress the transmitted payloads with gzip
+  bool gzip_requests_{false};
 
  private:
   std::shared_ptr<logging::Logger> logger_;
@@ -0,0 +1,65 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include "TestBase.h"
+#include "io/BufferStream.h"
+#include "io/ZlibStream.h"
+#include "utils/gsl.h"
+#include "protocols/RESTSender.h"
+
+class TestRESTSender : public minifi::c2::RESTSender {
+ public:
+  TestRESTSender()
+      : RESTSender("TestRESTSender") {
+  }
+
+  using RESTSender::gzipPayload;
+};
+
+std::string gunzip(const std::string &compressed) {
+  minifi::io::BufferStream output;
+  {
+    minifi::io::ZlibDecompressStream decompressor(gsl::make_not_null(&output));
+    const int size = gsl::narrow<int>(compressed.size());
+    REQUIRE(size == decompressor.write(reinterpret_cast<const uint8_t*>(compressed.data()), size));
+    REQUIRE(decompressor.isFinished());
+  }
+  return std::string(reinterpret_cast<const char*>(output.getBuffer()), output.size());
+}
+
+TEST_CASE("RESTSender gzips the payloads it sends", "[gzip]") {
+  TestRESTSender sender;
+
+  std::string payload = "{\"operation\":\"heartbeat\",\"agentInfo\":{\"agentClass\":\"default\"}";
+  for (int i = 0; i < 1000; ++i) {
+    payload += ",\"component" + std::to_string(i) + "\":{\"running\":true}";
+  }
+  payload += "}";
+
+  std::string compressed;
+  REQUIRE(sender.gzipPayload(payload, compressed));
+  REQUIRE(compressed.size() < payload.size());
+  REQUIRE(compressed.size() > 2);
+  REQUIRE(0x1f == static_cast<uint8_t>(compressed[0]));
+  REQUIRE(0x8b == static_cast<uint8_t>(compressed[1]));
+  REQUIRE(payload == gunzip(compressed));
+
+  REQUIRE(sender.gzipPayload("", compressed));
+  REQUIRE(gunzip(compressed).empty());
+}
@@ -279,24 +279,26 @@ void BinFiles::onTrigger(const std::shared_ptr<core::ProcessContext> &context, c
     }
   }
 
-  for (size_t i = 0; i < batchSize_; ++i) {
-    auto flow = session->get();
+  {
+    // the whole batch is ours at this point, so every FlowFile is routed even if some of them fail
+    bool hadFailure = false;
+    for (const auto& flow : session->get(batchSize_)) {
+      preprocessFlowFile(context.get(), session.get(), flow);
+      std::string groupId = getGroupId(context.get(), flow);
 
-    if (flow == nullptr) {
-      break;
+      bool offer = this->binManager_.offer(groupId, flow);
+      if (!offer) {
+        session->transfer(flow, Failure);
+        hadFailure = true;
+        continue;
+      }
+      // assuming ownership over the incoming flowFile
+      session->transfer(flow, Self);
     }
-
-    preprocessFlowFile(context.get(), session.get(), flow);
-    std::string groupId = getGroupId(context.get(), flow);
-
-    bool offer = this->binManager_.offer(groupId, flow);
-    if (!offer) {
-      session->transfer(flow, Failure);
+    if (hadFailure) {
       context->yield();
       return;
     }
-    // assuming ownership over the incoming flowFile
-    session->transfer(flow, Self);
   }
 
   // migrate bin to ready bin
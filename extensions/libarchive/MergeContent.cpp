@@ -415,7 +415,7 @@ std::map<std::string, std::string> AttributeMerger::getMergedAttributes() {
 }
 
 void KeepOnlyCommonAttributesMerger::processFlowFile(const std::shared_ptr<core::FlowFile> &flow_file, std::map<std::string, std::string> &merged_attributes) {
-  auto flow_attributes = flow_file->getAttributes();
+  std::map<std::string, std::string> flow_attributes = flow_file->getAttributes();
   std::map<std::string, std::string> tmp_merged;
   std::set_intersection(std::make_move_iterator(merged_attributes.begin()), std::make_move_iterator(merged_attributes.end()),
     std::make_move_iterator(flow_attributes.begin()), std::make_move_iterator(flow_attributes.end()), std::inserter(tmp_merged, tmp_merged.begin()));
@@ -423,8 +423,7 @@ void KeepOnlyCommonAttributesMerger::processFlowFile(const std::shared_ptr<core:
 }
 
 void KeepAllUniqueAttributesMerger::processFlowFile(const std::shared_ptr<core::FlowFile> &flow_file, std::map<std::string, std::string> &merged_attributes) {
-  auto flow_attributes = flow_file->getAttributes();
-  for (auto&& attr : flow_attributes) {
+  for (const auto& attr : flow_file->getAttributes()) {
     if(std::find(removed_attributes_.cbegin(), removed_attributes_.cend(), attr.first) != removed_attributes_.cend()) {
       continue;
     }
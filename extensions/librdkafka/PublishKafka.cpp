@@ -861,18 +861,10 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
   logger_->log_debug("PublishKafka onTrigger");
 
   // Collect FlowFiles to process
+  std::vector<std::shared_ptr<core::FlowFile>> flowFiles = session->get(batch_size_, target_batch_payload_size_);
   uint64_t actual_bytes = 0U;
-  std::vector<std::shared_ptr<core::FlowFile>> flowFiles;
-  for (uint32_t i = 0; i < batch_size_; i++) {
-    std::shared_ptr<core::FlowFile> flowFile = session->get();
-    if (flowFile == nullptr) {
-      break;
-    }
+  for (const auto& flowFile : flowFiles) {
     actual_bytes += flowFile->getSize();
-    flowFiles.emplace_back(std::move(flowFile));
-    if (target_batch_payload_size_ != 0U && actual_bytes >= target_batch_payload_size_) {
-      break;
-    }
   }
   if (flowFiles.empty()) {
     context->yield();
@@ -129,9 +129,9 @@ bool DatabaseContentRepository::exists(const minifi::ResourceClaim &streamId) {
     return false;
   }
   std::string value;
-  rocksdb::Status status;
-  status = opendb->Get(rocksdb::ReadOptions(), streamId.getContentFullPath(), &value);
-  if (status.ok()) {
+  // content written before it was stored in chunks is kept under the path itself
+  if (opendb->Get(rocksdb::ReadOptions(), io::RocksDbStream::getChunkKey(streamId.getContentFullPath(), 0), &value).ok()
+      || opendb->Get(rocksdb::ReadOptions(), streamId.getContentFullPath(), &value).ok()) {
     logger_->log_debug("%s exists", streamId.getContentFullPath());
     return true;
   } else {
@@ -147,13 +147,16 @@ bool DatabaseContentRepository::remove(const minifi::ResourceClaim &claim) {
   if (!opendb) {
     return false;
   }
-  rocksdb::Status status;
-  status = opendb->Delete(rocksdb::WriteOptions(), claim.getContentFullPath());
+  const std::string path = claim.getContentFullPath();
+  rocksdb::WriteBatch batch;
+  batch.Delete(path);
+  batch.DeleteRange(io::RocksDbStream::getChunkKey(path, 0), io::RocksDbStream::getChunkKeyLimit(path));
+  rocksdb::Status status = opendb->Write(rocksdb::WriteOptions(), &batch);
   if (status.ok()) {
-    logger_->log_debug("Deleting resource %s", claim.getContentFullPath());
+    logger_->log_debug("Deleting resource %s", path);
     return true;
   } else {
-    logger_->log_debug("Attempted, but could not delete %s", claim.getContentFullPath());
+    logger_->log_debug("Attempted, but could not delete %s", path);
     return false;
   }
 }
@@ -22,9 +22,13 @@
 #include "rocksdb/write_batch.h"
 #include "rocksdb/slice.h"
 
+#include <atomic>
+#include <cinttypes>
 #include <chrono>
+#include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 #include <list>
@@ -44,7 +48,16 @@ void FlowFileRepository::flush() {
   rocksdb::WriteBatch batch;
   rocksdb::ReadOptions options;
 
-  std::vector<std::shared_ptr<FlowFile>> purgeList;
+  std::vector<std::shared_ptr<ResourceClaim>> purgeList;
+
+  // the claims of these are carried with the delete request, no need to read them back
+  std::vector<ExpiredFlowFileInfo> flowFiles;
+  ExpiredFlowFileInfo flowFile;
+  while (flowfiles_to_delete.try_dequeue(flowFile)) {
+    logger_->log_debug("Issuing batch delete, including %s", flowFile.key);
+    batch.Delete(flowFile.key);
+    flowFiles.push_back(std::move(flowFile));
+  }
 
   std::vector<rocksdb::Slice> keys;
   std::list<std::string> keystrings;
@@ -58,36 +71,47 @@ void FlowFileRepository::flush() {
     }
   }
 
-  auto multistatus = opendb->MultiGet(options, keys, &values);
+  if (!keys.empty()) {
+    auto multistatus = opendb->MultiGet(options, keys, &values);
 
-  for(size_t i=0; i<keys.size() && i<values.size() && i<multistatus.size(); ++i) {
-    if(!multistatus[i].ok()) {
-      logger_->log_error("Failed to read key from rocksdb: %s! DB is most probably in an inconsistent state!", keys[i].data());
-      keystrings.remove(keys[i].data());
-      continue;
-    }
+    for (size_t i = 0; i < keys.size() && i < values.size() && i < multistatus.size(); ++i) {
+      if (!multistatus[i].ok()) {
+        logger_->log_error("Failed to read key from rocksdb: %s! DB is most probably in an inconsistent state!", keys[i].data());
+        keystrings.remove(keys[i].data());
+        continue;
+      }
 
-    utils::Identifier containerId;
-    auto eventRead = FlowFileRecord::DeSerialize(reinterpret_cast<const uint8_t *>(values[i].data()), values[i].size(), content_repo_, containerId);
-    if (eventRead) {
-      purgeList.push_back(eventRead);
+      utils::Identifier containerId;
+      auto eventRead = FlowFileRecord::DeSerialize(reinterpret_cast<const uint8_t *>(values[i].data()), values[i].size(), content_repo_, containerId);
+      if (eventRead) {
+        purgeList.push_back(eventRead->getResourceClaim());
+        logger_->log_debug("Issuing batch delete, including %s, Content path %s", eventRead->getUUIDStr(), eventRead->getContentFullPath());
+      }
+      batch.Delete(keys[i]);
     }
-    logger_->log_debug("Issuing batch delete, including %s, Content path %s", eventRead->getUUIDStr(), eventRead->getContentFullPath());
-    batch.Delete(keys[i]);
+  }
+
+  if (batch.Count() == 0) {
+    return;
   }
 
   auto operation = [&batch, &opendb]() { return opendb->Write(rocksdb::WriteOptions(), &batch); };
 
   if (!ExecuteWithRetry(operation)) {
-    for (const auto& key: keystrings) {
+    for (auto& ff : flowFiles) {
+      flowfiles_to_delete.enqueue(std::move(ff));
+    }
+    for (const auto& key : keystrings) {
       keys_to_delete.enqueue(key);  // Push back the values that we could get but couldn't delete
     }
     return;  // Stop here - don't delete from content repo while we have records in FF repo
   }
 
   if (content_repo_) {
-    for (const auto &ffr : purgeList) {
-      auto claim = ffr->getResourceClaim();
+    for (const auto &ff : flowFiles) {
+      if (ff.content) ff.content->decreaseFlowFileRecordOwnedCount();
+    }
+    for (const auto &claim : purgeList) {
       if (claim) claim->decreaseFlowFileRecordOwnedCount();
     }
   }
@@ -134,13 +158,13 @@ void FlowFileRepository::prune_stored_flowfiles() {
   options.use_direct_io_for_flush_and_compaction = true;
   options.use_direct_reads = true;
   minifi::internal::RocksDatabase checkpointDB(options, FLOWFILE_CHECKPOINT_DIRECTORY, minifi::internal::RocksDatabase::Mode::ReadOnly);
-  utils::optional<minifi::internal::OpenRocksDB> opendb;
+  minifi::internal::RocksDatabase *database = nullptr;
   if (nullptr != checkpoint_) {
-    opendb = checkpointDB.open();
-    if (!opendb) {
-      opendb = db_->open();
-    }
-    if (!opendb) {
+    if (checkpointDB.open()) {
+      database = &checkpointDB;
+    } else if (db_->open()) {
+      database = db_.get();
+    } else {
       logger_->log_trace("Could not open neither the checkpoint nor the live database.");
       return;
     }
@@ -149,8 +173,78 @@ void FlowFileRepository::prune_stored_flowfiles() {
     return;
   }
 
+  const auto start = std::chrono::steady_clock::now();
+
+  const std::vector<std::string> boundaries = split_key_range(*database, recovery_threads_);
+  const size_t range_count = boundaries.size() - 1;
+
+  std::atomic<uint64_t> restored{0};
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < range_count; ++i) {
+    threads.emplace_back([this, database, &boundaries, &restored, i] {
+      restored += prune_stored_flowfiles(*database, boundaries[i], boundaries[i + 1]);
+    });
+  }
+  restored += prune_stored_flowfiles(*database, boundaries[0], boundaries[1]);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  recovery_time_millis_ = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  recovered_ = true;
+  logger_->log_info("Restored %" PRIu64 " flow files in %" PRIu64 " ms using %u threads", restored.load(), recovery_time_millis_.load(), static_cast<uint32_t>(range_count));
+}
+
+std::vector<std::string> FlowFileRepository::split_key_range(minifi::internal::RocksDatabase &database, size_t range_count) {
+  // the sample is bounded by keeping only every stride-th key and doubling the stride whenever the sample fills up,
+  // so it stays evenly spread over the keys however many there are
+  static const size_t MAX_SAMPLE_SIZE = 1024;
+
+  std::vector<std::string> boundaries{""};
+  auto opendb = range_count > 1 ? database.open() : utils::nullopt;
+  if (opendb) {
+    std::vector<std::string> sample;
+    uint64_t stride = 1;
+    uint64_t count = 0;
+    auto it = opendb->NewIterator(rocksdb::ReadOptions());
+    for (it->SeekToFirst(); it->Valid(); it->Next(), ++count) {
+      if (count % stride != 0) {
+        continue;
+      }
+      sample.push_back(it->key().ToString());
+      if (sample.size() == MAX_SAMPLE_SIZE) {
+        for (size_t i = 0; i < sample.size() / 2; ++i) {
+          sample[i] = std::move(sample[2 * i]);
+        }
+        sample.resize(sample.size() / 2);
+        stride *= 2;
+      }
+    }
+    // the ranges are cut at equal counts of sampled keys, there are fewer ranges than requested if there are only a few keys
+    for (size_t i = 1; i < range_count && !sample.empty(); ++i) {
+      const std::string &boundary = sample[i * sample.size() / range_count];
+      if (boundary > boundaries.back()) {
+        boundaries.push_back(boundary);
+      }
+    }
+  }
+  // the first and the last range are open, so that keys written since the sampling are recovered too
+  boundaries.push_back("");
+  return boundaries;
+}
+
+uint64_t FlowFileRepository::prune_stored_flowfiles(minifi::internal::RocksDatabase &database, const std::string &first_key, const std::string &last_key) {
+  // connections receive the restored flow files in batches, so that their consumers can start early
+  static const size_t RESTORE_BATCH_SIZE = 1024;
+
+  auto opendb = database.open();
+  if (!opendb) {
+    return 0;
+  }
+  uint64_t restored = 0;
+  std::map<std::shared_ptr<core::Connectable>, std::vector<std::shared_ptr<core::FlowFile>>> restore_batches;
   auto it = opendb->NewIterator(rocksdb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+  for (first_key.empty() ? it->SeekToFirst() : it->Seek(first_key); it->Valid() && (last_key.empty() || it->key().compare(last_key) < 0); it->Next()) {
     utils::Identifier containerId;
     auto eventRead = FlowFileRecord::DeSerialize(reinterpret_cast<const uint8_t *>(it->value().data()), it->value().size(), content_repo_, containerId);
     std::string key = it->key().ToString();
@@ -171,15 +265,105 @@ void FlowFileRepository::prune_stored_flowfiles() {
         eventRead->setStoredToRepository(true);
         // we found the connection for the persistent flowFile
         // even if a processor immediately marks it for deletion, flush only happens after prune_stored_flowfiles
-        search->second->restore(eventRead);
+        auto &batch = restore_batches[search->second];
+        batch.push_back(eventRead);
+        if (batch.size() >= RESTORE_BATCH_SIZE) {
+          restored += batch.size();
+          search->second->multiRestore(batch);
+          batch.clear();
+        }
       } else {
         logger_->log_warn("Could not find connection for %s, path %s ", containerId.to_string(), eventRead->getContentFullPath());
-        keys_to_delete.enqueue(key);
+        flowfiles_to_delete.enqueue(ExpiredFlowFileInfo{key, claim});
       }
     } else {
       // failed to deserialize FlowFile, cannot clear claim
-      keys_to_delete.enqueue(key);
+      flowfiles_to_delete.enqueue(ExpiredFlowFileInfo{key, nullptr});
+    }
+  }
+  for (auto &batch : restore_batches) {
+    if (!batch.second.empty()) {
+      restored += batch.second.size();
+      batch.first->multiRestore(batch.second);
+    }
+  }
+  return restored;
+}
+
+bool FlowFileRepository::addToBatch(rocksdb::WriteBatch& batch, const std::vector<std::pair<std::string, std::unique_ptr<minifi::io::BufferStream>>>& data) {
+  for (const auto &item : data) {
+    rocksdb::Slice value((const char *) item.second->getBuffer(), item.second->size());
+    if (!batch.Put(item.first, value).ok()) {
+      logger_->log_error("Failed to add item to batch operation");
+      return false;
+    }
+  }
+  return true;
+}
+
+void FlowFileRepository::startGroupCommit() {
+  std::lock_guard<std::mutex> lock(group_commit_mutex_);
+  if (group_commit_running_) {
+    return;
+  }
+  group_commit_running_ = true;
+  group_commit_thread_ = std::thread(&FlowFileRepository::runGroupCommit, this);
+  logger_->log_debug("%s group commit started", getName());
+}
+
+void FlowFileRepository::stopGroupCommit() {
+  {
+    std::lock_guard<std::mutex> lock(group_commit_mutex_);
+    group_commit_running_ = false;
+  }
+  group_commit_condition_.notify_all();
+  if (group_commit_thread_.joinable()) {
+    group_commit_thread_.join();
+  }
+}
+
+void FlowFileRepository::runGroupCommit() {
+  std::vector<PendingCommit*> commits;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(group_commit_mutex_);
+      group_commit_condition_.wait(lock, [this] { return !pending_commits_.empty() || !group_commit_running_; });
+      if (pending_commits_.empty()) {
+        // stopped, new commits are written by the sessions themselves
+        return;
+      }
+      // the commits arriving while this group is written form the next group
+      commits.swap(pending_commits_);
+    }
+
+    std::vector<bool> added(commits.size(), false);
+    rocksdb::WriteBatch batch;
+    for (size_t i = 0; i < commits.size(); ++i) {
+      batch.SetSavePoint();
+      added[i] = addToBatch(batch, *commits[i]->data);
+      if (!added[i]) {
+        // fail only the commit whose records could not be added
+        batch.RollbackToSavePoint();
+      }
+    }
+
+    bool written = true;
+    auto opendb = db_->open();
+    if (!opendb) {
+      written = false;
+    } else if (batch.Count() > 0) {
+      // the whole group shares one sync of the write-ahead log, so the released sessions are durable
+      rocksdb::WriteOptions options;
+      options.sync = true;
+      auto operation = [&batch, &opendb, &options]() { return opendb->Write(options, &batch); };
+      written = ExecuteWithRetry(operation);
+    }
+    logger_->log_trace("Group commit of %zu sessions finished", commits.size());
+
+    for (size_t i = 0; i < commits.size(); ++i) {
+      commits[i]->result.set_value(written && added[i]);
     }
+    commits.clear();
   }
 }
 
@@ -18,6 +18,16 @@
 #ifndef LIBMINIFI_INCLUDE_CORE_REPOSITORY_FLOWFILEREPOSITORY_H_
 #define LIBMINIFI_INCLUDE_CORE_REPOSITORY_FLOWFILEREPOSITORY_H_
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include "utils/file/FileUtils.h"
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
@@ -52,6 +62,13 @@ namespace repository {
 /**
  * Flow File repository
  * Design: Extends Repository and implements the run function, using rocksdb as the primary substrate.
+ *
+ * In group commit mode (nifi.flowfile.repository.group.commit) MultiPut hands the records to a
+ * dedicated writer thread, which writes the records of all the sessions committing at the same
+ * time in a single synced batch and then releases them together.
+ *
+ * At startup the persisted flow files are recovered by several threads, each walking its own
+ * key range of the checkpoint, while the flow is already running.
  */
 class FlowFileRepository : public core::Repository, public std::enable_shared_from_this<FlowFileRepository> {
  public:
@@ -67,10 +84,18 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
         Repository(repo_name.length() > 0 ? repo_name : core::getClassName<FlowFileRepository>(), directory, maxPartitionMillis, maxPartitionBytes, purgePeriod),
         content_repo_(nullptr),
         checkpoint_(nullptr),
+        group_commit_running_(false),
+        recovery_threads_((std::max)(1U, std::thread::hardware_concurrency())),
+        recovery_time_millis_(0),
+        recovered_(false),
         logger_(logging::LoggerFactory<FlowFileRepository>::getLogger()) {
     db_ = NULL;
   }
 
+  ~FlowFileRepository() override {
+    stopGroupCommit();
+  }
+
   virtual bool isNoop() {
     return false;
   }
@@ -97,6 +122,13 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
       }
     }
     logger_->log_debug("NiFi FlowFile Max Storage Time: [%d] ms", max_partition_millis_);
+    if (configure->get(Configure::nifi_flowfile_repository_recovery_threads, value)) {
+      uint32_t recovery_threads;
+      if (Property::StringToInt(value, recovery_threads) && recovery_threads > 0) {
+        recovery_threads_ = recovery_threads;
+      }
+    }
+    logger_->log_debug("NiFi FlowFile Recovery Threads: %u", recovery_threads_);
     rocksdb::Options options;
     options.create_if_missing = true;
     options.use_direct_io_for_flush_and_compaction = true;
@@ -114,6 +146,10 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
     db_ = utils::make_unique<minifi::internal::RocksDatabase>(options, directory_);
     if (db_->open()) {
       logger_->log_debug("NiFi FlowFile Repository database open %s success", directory_);
+      bool group_commit = false;
+      if (configure->get(Configure::nifi_flowfile_repository_group_commit, value) && utils::StringUtils::StringToBool(value, group_commit) && group_commit) {
+        startGroupCommit();
+      }
       return true;
     } else {
       logger_->log_error("NiFi FlowFile Repository database open %s fail", directory_);
@@ -135,23 +171,34 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
   }
 
   virtual bool MultiPut(const std::vector<std::pair<std::string, std::unique_ptr<minifi::io::BufferStream>>>& data) {
+    if (group_commit_running_) {
+      PendingCommit commit{&data, {}};
+      auto committed = commit.result.get_future();
+      bool queued = false;
+      {
+        std::lock_guard<std::mutex> lock(group_commit_mutex_);
+        if (group_commit_running_) {
+          pending_commits_.push_back(&commit);
+          queued = true;
+        }
+      }
+      if (queued) {
+        group_commit_condition_.notify_one();
+        return committed.get();
+      }
+    }
     auto opendb = db_->open();
     if (!opendb) {
       return false;
     }
     rocksdb::WriteBatch batch;
-    for (const auto &item: data) {
-      rocksdb::Slice value((const char *) item.second->getBuffer(), item.second->size());
-      if (!batch.Put(item.first, value).ok()) {
-        logger_->log_error("Failed to add item to batch operation");
-        return false;
-      }
+    if (!addToBatch(batch, data)) {
+      return false;
     }
     auto operation = [&batch, &opendb]() { return opendb->Write(rocksdb::WriteOptions(), &batch); };
     return ExecuteWithRetry(operation);
   }
 
-
   /**
    * 
    * Deletes the key
@@ -161,6 +208,16 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
     keys_to_delete.enqueue(key);
     return true;
   }
+
+  /**
+   * Deletes the key without reading the record back, the claim
+   * is released once the delete is persisted
+   * @return status of the delete operation
+   */
+  bool Delete(const std::string &key, const std::shared_ptr<ResourceClaim> &claim) override {
+    flowfiles_to_delete.enqueue(ExpiredFlowFileInfo{key, claim});
+    return true;
+  }
   /**
    * Sets the value from the provided key
    * @return status of the get operation.
@@ -175,6 +232,19 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
 
   virtual void loadComponent(const std::shared_ptr<core::ContentRepository> &content_repo);
 
+  bool getRecoveryTime(uint64_t &millis) const override {
+    if (!recovered_) {
+      return false;
+    }
+    millis = recovery_time_millis_;
+    return true;
+  }
+
+  void stop() override {
+    stopGroupCommit();
+    Repository::stop();
+  }
+
   void start() {
     if (this->purge_period_ <= 0) {
       return;
@@ -188,9 +258,24 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
   }
 
  private:
+  struct PendingCommit {
+    const std::vector<std::pair<std::string, std::unique_ptr<minifi::io::BufferStream>>>* data;
+    std::promise<bool> result;
+  };
 
   bool ExecuteWithRetry(std::function<rocksdb::Status()> operation);
 
+  bool addToBatch(rocksdb::WriteBatch& batch, const std::vector<std::pair<std::string, std::unique_ptr<minifi::io::BufferStream>>>& data);
+
+  void startGroupCommit();
+
+  void stopGroupCommit();
+
+  /**
+   * Writes the pending commits in batches until the group commit is stopped.
+   */
+  void runGroupCommit();
+
   /**
    * Initialize the repository
    */
@@ -207,10 +292,42 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
    */
   void prune_stored_flowfiles();
 
+  /**
+   * Splits the keys of the database into at most range_count ranges holding similar numbers of keys,
+   * using a sample of the keys taken in a single pass.
+   * @return the boundaries of the ranges, starting and ending with an empty key for the open ends
+   */
+  std::vector<std::string> split_key_range(minifi::internal::RocksDatabase &database, size_t range_count);
+
+  /**
+   * Restores the stored flow files whose keys fall in [first_key, last_key) to their connections.
+   * An empty first_key or last_key leaves that end of the range open.
+   * @return number of flow files restored
+   */
+  uint64_t prune_stored_flowfiles(minifi::internal::RocksDatabase &database, const std::string &first_key, const std::string &last_key);
+
+  struct ExpiredFlowFileInfo {
+    std::string key;
+    std::shared_ptr<ResourceClaim> content;
+  };
+
+  // keys of records whose claim is unknown, these have to be read back before deleting them
   moodycamel::ConcurrentQueue<std::string> keys_to_delete;
+  moodycamel::ConcurrentQueue<ExpiredFlowFileInfo> flowfiles_to_delete;
   std::shared_ptr<core::ContentRepository> content_repo_;
   std::unique_ptr<minifi::internal::RocksDatabase> db_;
   std::unique_ptr<rocksdb::Checkpoint> checkpoint_;
+
+  std::atomic<bool> group_commit_running_;
+  std::mutex group_commit_mutex_;
+  std::condition_variable group_commit_condition_;
+  std::vector<PendingCommit*> pending_commits_;
+  std::thread group_commit_thread_;
+
+  uint32_t recovery_threads_;
+  std::atomic<uint64_t> recovery_time_millis_;
+  std::atomic<bool> recovered_;
+
   std::shared_ptr<logging::Logger> logger_;
 };
 
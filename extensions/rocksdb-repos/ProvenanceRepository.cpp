@@ -17,7 +17,11 @@
  */
 
 #include "ProvenanceRepository.h"
+#include <memory>
 #include <string>
+#include <vector>
+#include "io/BufferStream.h"
+
 namespace org {
 namespace apache {
 namespace nifi {
@@ -50,6 +54,77 @@ void ProvenanceRepository::run() {
     }
   }
 }
+
+void ProvenanceRepository::startAsyncWrite() {
+  std::lock_guard<std::mutex> lock(async_write_mutex_);
+  if (async_write_running_) {
+    return;
+  }
+  async_write_running_ = true;
+  async_write_thread_ = std::thread(&ProvenanceRepository::runAsyncWrite, this);
+  logger_->log_debug("%s async write started", getName());
+}
+
+void ProvenanceRepository::stopAsyncWrite() {
+  {
+    std::lock_guard<std::mutex> lock(async_write_mutex_);
+    async_write_running_ = false;
+  }
+  async_write_condition_.notify_all();
+  if (async_write_thread_.joinable()) {
+    async_write_thread_.join();
+  }
+}
+
+void ProvenanceRepository::runAsyncWrite() {
+  while (async_write_running_) {
+    {
+      std::unique_lock<std::mutex> lock(async_write_mutex_);
+      // the sessions notify without taking the lock, so a missed notification delays the write by at most one period
+      async_write_condition_.wait_for(lock, std::chrono::milliseconds(PROVENANCE_ASYNC_WRITE_PERIOD),
+                                      [this] { return pending_elements_.size_approx() > 0 || !async_write_running_; });
+    }
+    writePendingElements();
+  }
+  // stopped, new elements are written by the sessions themselves
+  writePendingElements();
+}
+
+void ProvenanceRepository::writePendingElements() {
+  std::vector<std::shared_ptr<core::SerializableComponent>> elements(PROVENANCE_ASYNC_WRITE_BATCH_SIZE);
+  io::BufferStream stream;
+  size_t count;
+  while ((count = pending_elements_.try_dequeue_bulk(elements.begin(), elements.size())) > 0) {
+    rocksdb::WriteBatch batch;
+    for (size_t i = 0; i < count; ++i) {
+      auto event = std::dynamic_pointer_cast<ProvenanceEventRecord>(elements[i]);
+      elements[i].reset();
+      if (event == nullptr) {
+        logger_->log_error("Only provenance events can be stored in %s", getName());
+        continue;
+      }
+      // the batch copies the record, so the stream can be reused
+      stream.initialize();
+      if (!event->Serialize(stream)) {
+        logger_->log_error("Failed to serialize provenance event %s", event->getUUIDStr());
+        continue;
+      }
+      const std::string key = event->getUUIDStr();
+      batch.Put(key, rocksdb::Slice(reinterpret_cast<const char*>(stream.getBuffer()), stream.size()));
+    }
+    if (db_ == nullptr) {
+      logger_->log_error("Dropping %u provenance events, the database is closed", batch.Count());
+      continue;
+    }
+    rocksdb::Status status = db_->Write(rocksdb::WriteOptions(), &batch);
+    if (!status.ok()) {
+      logger_->log_error("Writing %u provenance events failed: %s", batch.Count(), status.ToString());
+    } else {
+      logger_->log_trace("Wrote %u provenance events", batch.Count());
+    }
+  }
+}
+
 } /* namespace provenance */
 } /* namespace minifi */
 } /* namespace nifi */
@@ -17,6 +17,15 @@
 #ifndef LIBMINIFI_INCLUDE_PROVENANCE_PROVENANCEREPOSITORY_H_
 #define LIBMINIFI_INCLUDE_PROVENANCE_PROVENANCEREPOSITORY_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
@@ -24,6 +33,8 @@
 #include "core/Core.h"
 #include "provenance/Provenance.h"
 #include "core/logging/LoggerConfiguration.h"
+#include "utils/StringUtils.h"
+#include "concurrentqueue.h"
 namespace org {
 namespace apache {
 namespace nifi {
@@ -34,6 +45,15 @@ namespace provenance {
 #define MAX_PROVENANCE_STORAGE_SIZE (10*1024*1024)  // 10M
 #define MAX_PROVENANCE_ENTRY_LIFE_TIME (60000)  // 1 minute
 #define PROVENANCE_PURGE_PERIOD (2500)  // 2500 msec
+#define PROVENANCE_ASYNC_WRITE_PERIOD (100)  // 100 msec
+#define PROVENANCE_ASYNC_WRITE_BATCH_SIZE (1000)
+
+/**
+ * Provenance repository backed by rocksdb.
+ *
+ * With nifi.provenance.repository.async.write the sessions only queue their events, which a dedicated
+ * writer thread serializes and writes in batches, so the committing processors don't pay for it.
+ */
 
 class ProvenanceRepository : public core::Repository, public std::enable_shared_from_this<ProvenanceRepository> {
  public:
@@ -50,10 +70,15 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
                        uint64_t purgePeriod = PROVENANCE_PURGE_PERIOD)
       : core::SerializableComponent(repo_name),
         Repository(repo_name.length() > 0 ? repo_name : core::getClassName<ProvenanceRepository>(), directory, maxPartitionMillis, maxPartitionBytes, purgePeriod),
+        async_write_running_(false),
         logger_(logging::LoggerFactory<ProvenanceRepository>::getLogger()) {
     db_ = NULL;
   }
 
+  ~ProvenanceRepository() override {
+    stopAsyncWrite();
+  }
+
   void printStats();
 
   virtual bool isNoop() {
@@ -116,6 +141,11 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
       return false;
     }
 
+    bool async_write = false;
+    if (config->get(Configure::nifi_provenance_repository_async_write, value) && utils::StringUtils::StringToBool(value, async_write) && async_write) {
+      startAsyncWrite();
+    }
+
     return true;
   }
   // Put
@@ -136,6 +166,19 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
     return db_->Write(rocksdb::WriteOptions(), &batch).ok();
   }
 
+  bool storeElements(const std::vector<std::shared_ptr<core::SerializableComponent>>& elements) override {
+    if (!async_write_running_) {
+      return Repository::storeElements(elements);
+    }
+    pending_elements_.enqueue_bulk(elements.begin(), elements.size());
+    async_write_condition_.notify_one();
+    if (!async_write_running_) {
+      // the writer might have stopped before taking the elements
+      writePendingElements();
+    }
+    return true;
+  }
+
   // Delete
   virtual bool Delete(std::string key) {
     // The repo is cleaned up by itself, there is no need to delete items.
@@ -212,8 +255,14 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
     return max_size > 0;
   }
 
+  void stop() override {
+    stopAsyncWrite();
+    Repository::stop();
+  }
+
   // destroy
   void destroy() {
+    stopAsyncWrite();
     db_.reset();
   }
   // Run function for the thread
@@ -232,7 +281,28 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
   ProvenanceRepository &operator=(const ProvenanceRepository &parent) = delete;
 
  private:
+  void startAsyncWrite();
+
+  void stopAsyncWrite();
+
+  /**
+   * Writes the queued elements until the async write is stopped.
+   */
+  void runAsyncWrite();
+
+  /**
+   * Serializes the queued elements and writes them in batches, until the queue is empty.
+   */
+  void writePendingElements();
+
   std::unique_ptr<rocksdb::DB> db_;
+
+  std::atomic<bool> async_write_running_;
+  moodycamel::ConcurrentQueue<std::shared_ptr<core::SerializableComponent>> pending_elements_;
+  std::mutex async_write_mutex_;
+  std::condition_variable async_write_condition_;
+  std::thread async_write_thread_;
+
   std::shared_ptr<logging::Logger> logger_;
 };
 
@@ -17,11 +17,16 @@
  */
 
 #include "RocksDbStream.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
 #include <fstream>
+#include <limits>
 #include <utility>
 #include <vector>
 #include <memory>
 #include <string>
+#include "rocksdb/write_batch.h"
 #include <Exception.h>
 #include "io/validation.h"
 namespace org {
@@ -30,24 +35,77 @@ namespace nifi {
 namespace minifi {
 namespace io {
 
+namespace {
+
+const char CHUNK_KEY_SEPARATOR = '\0';
+
+uint64_t getChunkOffset(const rocksdb::Slice& key) {
+  uint64_t offset = 0;
+  for (size_t i = key.size() - sizeof(uint64_t); i < key.size(); ++i) {
+    offset = (offset << 8) | static_cast<uint8_t>(key[i]);
+  }
+  return offset;
+}
+
+bool isChunkKeyOf(const rocksdb::Slice& key, const std::string& path) {
+  return key.size() == path.size() + 1 + sizeof(uint64_t) && key.starts_with(path) && key[path.size()] == CHUNK_KEY_SEPARATOR;
+}
+
+}  // namespace
+
+constexpr size_t RocksDbStream::CHUNK_SIZE;
+
 RocksDbStream::RocksDbStream(std::string path, gsl::not_null<minifi::internal::RocksDatabase*> db, bool write_enable, rocksdb::WriteBatch* batch)
     : BaseStream(),
       path_(std::move(path)),
       write_enable_(write_enable),
+      exists_(false),
+      offset_(0),
+      chunk_offset_(0),
       db_(db),
       batch_(batch),
+      size_(0),
       logger_(logging::LoggerFactory<RocksDbStream>::getLogger()) {
   auto opendb = db_->open();
-  exists_ = opendb && opendb->Get(rocksdb::ReadOptions(), path_, &value_).ok();
-  offset_ = 0;
-  size_ = value_.size();
+  if (!opendb) {
+    return;
+  }
+  // the size of the content is known from its last chunk
+  auto iterator = opendb->NewIterator(rocksdb::ReadOptions());
+  iterator->SeekForPrev(getChunkKey(path_, (std::numeric_limits<uint64_t>::max)()));
+  if (iterator->Valid() && isChunkKeyOf(iterator->key(), path_)) {
+    exists_ = true;
+    size_ = gsl::narrow<size_t>(getChunkOffset(iterator->key()) + iterator->value().size());
+  } else if (opendb->Get(rocksdb::ReadOptions(), path_, &chunk_).ok()) {
+    // content written before it was stored in chunks
+    exists_ = true;
+    size_ = chunk_.size();
+  }
+}
+
+std::string RocksDbStream::getChunkKey(const std::string &path, uint64_t offset) {
+  std::string key;
+  key.reserve(path.size() + 1 + sizeof(uint64_t));
+  key.append(path);
+  key.push_back(CHUNK_KEY_SEPARATOR);
+  // big-endian, so that the chunks are ordered by their offset
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    key.push_back(static_cast<char>((offset >> shift) & 0xFF));
+  }
+  return key;
+}
+
+std::string RocksDbStream::getChunkKeyLimit(const std::string &path) {
+  std::string key(path);
+  key.push_back(static_cast<char>(CHUNK_KEY_SEPARATOR + 1));
+  return key;
 }
 
 void RocksDbStream::close() {
 }
 
 void RocksDbStream::seek(uint64_t offset) {
-  // noop
+  offset_ = gsl::narrow<size_t>((std::min<uint64_t>)(offset, size_));
 }
 
 int RocksDbStream::write(const uint8_t *value, int size) {
@@ -63,26 +121,66 @@ int RocksDbStream::write(const uint8_t *value, int size) {
     if (!opendb) {
       return -1;
     }
-    rocksdb::Slice slice_value((const char *) value, size);
-    rocksdb::Status status;
-    size_ += size;
-    if (batch_ != nullptr) {
-      status = batch_->Merge(path_, slice_value);
-    } else {
+    // the chunks of a single write are committed together
+    rocksdb::WriteBatch own_batch;
+    rocksdb::WriteBatch* batch = batch_ != nullptr ? batch_ : &own_batch;
+    for (size_t written = 0; written < gsl::narrow<size_t>(size);) {
+      const size_t chunk_size = (std::min)(CHUNK_SIZE, gsl::narrow<size_t>(size) - written);
+      rocksdb::Slice slice_value(reinterpret_cast<const char*>(value) + written, chunk_size);
+      rocksdb::Status status = batch->Put(getChunkKey(path_, size_ + written), slice_value);
+      if (!status.ok()) {
+        return -1;
+      }
+      written += chunk_size;
+    }
+    if (batch_ == nullptr) {
       rocksdb::WriteOptions opts;
       opts.sync = true;
-      status = opendb->Merge(opts, path_, slice_value);
-    }
-    if (status.ok()) {
-      return size;
-    } else {
-      return -1;
+      if (!opendb->Write(opts, &own_batch).ok()) {
+        return -1;
+      }
     }
+    size_ += size;
+    exists_ = true;
+    return size;
   } else {
     return -1;
   }
 }
 
+bool RocksDbStream::loadChunk(size_t offset) {
+  if (offset >= chunk_offset_ && offset < chunk_offset_ + chunk_.size()) {
+    return true;
+  }
+  auto opendb = db_->open();
+  if (!opendb) {
+    return false;
+  }
+  if (offset == chunk_offset_ + chunk_.size()) {
+    // reading sequentially, the next chunk starts where the current one ends
+    std::string chunk;
+    if (opendb->Get(rocksdb::ReadOptions(), getChunkKey(path_, offset), &chunk).ok() && !chunk.empty()) {
+      chunk_ = std::move(chunk);
+      chunk_offset_ = offset;
+      return true;
+    }
+  }
+  auto iterator = opendb->NewIterator(rocksdb::ReadOptions());
+  iterator->SeekForPrev(getChunkKey(path_, offset));
+  if (iterator->Valid() && isChunkKeyOf(iterator->key(), path_)) {
+    chunk_offset_ = gsl::narrow<size_t>(getChunkOffset(iterator->key()));
+    chunk_.assign(iterator->value().data(), iterator->value().size());
+  } else if (opendb->Get(rocksdb::ReadOptions(), path_, &chunk_).ok()) {
+    // content written before it was stored in chunks, appended chunks follow it
+    chunk_offset_ = 0;
+  } else {
+    chunk_.clear();
+    chunk_offset_ = 0;
+    return false;
+  }
+  return offset >= chunk_offset_ && offset < chunk_offset_ + chunk_.size();
+}
+
 int RocksDbStream::read(uint8_t *buf, int buflen) {
   gsl_Expects(buflen >= 0);
   if (!exists_) {
@@ -92,16 +190,19 @@ int RocksDbStream::read(uint8_t *buf, int buflen) {
     return 0;
   }
   if (!IsNullOrEmpty(buf)) {
-    size_t amtToRead = gsl::narrow<size_t>(buflen);
-    if (offset_ >= value_.size()) {
-      return 0;
-    }
-    if (amtToRead > value_.size() - offset_) {
-      amtToRead = value_.size() - offset_;
+    size_t read_size = 0;
+    while (read_size < gsl::narrow<size_t>(buflen) && offset_ < size_) {
+      if (!loadChunk(offset_)) {
+        logger_->log_error("Content of %s is missing at offset %" PRIu64, path_, static_cast<uint64_t>(offset_));
+        return read_size > 0 ? gsl::narrow<int>(read_size) : -1;
+      }
+      const size_t chunk_position = offset_ - chunk_offset_;
+      const size_t amtToRead = (std::min)(gsl::narrow<size_t>(buflen) - read_size, chunk_.size() - chunk_position);
+      std::memcpy(buf + read_size, chunk_.data() + chunk_position, amtToRead);
+      read_size += amtToRead;
+      offset_ += amtToRead;
     }
-    std::memcpy(buf, value_.data() + offset_, amtToRead);
-    offset_ += amtToRead;
-    return gsl::narrow<int>(amtToRead);
+    return gsl::narrow<int>(read_size);
   } else {
     return -1;
   }
@@ -33,17 +33,20 @@ namespace minifi {
 namespace io {
 
 /**
- * Purpose: File Stream Base stream extension. This is intended to be a thread safe access to
- * read/write to the local file system.
+ * Purpose: Stream over content stored in RocksDB.
  *
- * Design: Simply extends BaseStream and overrides readData/writeData to allow a sink to the
- * fstream object.
+ * Design: Content is split into chunks of at most CHUNK_SIZE bytes, each stored under the key
+ * returned by getChunkKey for the offset of its first byte. Reads fetch one chunk at a time,
+ * so the memory used by a stream does not depend on the size of the content. Content stored as
+ * a single value under the path by earlier versions is still readable.
  */
 class RocksDbStream : public io::BaseStream {
  public:
+  static constexpr size_t CHUNK_SIZE = 1024 * 1024;
+
   /**
-   * File Stream constructor that accepts an fstream shared pointer.
-   * It must already be initialized for read and write.
+   * Creates a stream over the content stored for path. Writes are appended to the
+   * existing content, either directly to the database or to batch if it is given.
    */
   explicit RocksDbStream(std::string path, gsl::not_null<minifi::internal::RocksDatabase*> db, bool write_enable = false, rocksdb::WriteBatch* batch = nullptr);
 
@@ -79,6 +82,16 @@ class RocksDbStream : public io::BaseStream {
    */
   int write(const uint8_t *value, int size) override;
 
+  /**
+   * Returns the key of the chunk starting at offset in the content stored for path.
+   */
+  static std::string getChunkKey(const std::string &path, uint64_t offset);
+
+  /**
+   * Returns a key greater than the key of every chunk of the content stored for path.
+   */
+  static std::string getChunkKeyLimit(const std::string &path);
+
  protected:
   std::string path_;
 
@@ -88,7 +101,9 @@ class RocksDbStream : public io::BaseStream {
 
   size_t offset_;
 
-  std::string value_;
+  // the chunk the stream is reading from and the offset of its first byte
+  std::string chunk_;
+  size_t chunk_offset_;
 
   gsl::not_null<minifi::internal::RocksDatabase*> db_;
 
@@ -97,9 +112,9 @@ class RocksDbStream : public io::BaseStream {
   size_t size_;
 
  private:
+  bool loadChunk(size_t offset);
 
   std::shared_ptr<logging::Logger> logger_;
-
 };
 
 } /* namespace io */
@@ -23,17 +23,14 @@
 #include <memory>
 #include <map>
 #include <set>
-#include <regex>
-#include <iostream>
-#include <sstream>
 #include <utility>
+#include <vector>
 
 #include "ExtractText.h"
 #include "core/ProcessContext.h"
 #include "core/ProcessSession.h"
 #include "core/FlowFile.h"
-
-#include "utils/RegexUtils.h"
+#include "Exception.h"
 
 namespace org {
 namespace apache {
@@ -100,6 +97,36 @@ void ExtractText::initialize() {
   setSupportedRelationships(relationships);
 }
 
+void ExtractText::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory* /*sessionFactory*/) {
+  regexes_.clear();
+
+  bool regex_mode = false;
+  context->getProperty(RegexMode.getName(), regex_mode);
+  if (!regex_mode) {
+    return;
+  }
+
+  std::vector<utils::Regex::Mode> rgx_mode;
+  bool insensitive;
+  if (context->getProperty(InsensitiveMatch.getName(), insensitive) && insensitive) {
+    rgx_mode.push_back(utils::Regex::Mode::ICASE);
+  }
+
+  for (const auto& k : context->getDynamicPropertyKeys()) {
+    std::string value;
+    context->getDynamicProperty(k, value);
+    if (value.empty()) {
+      continue;
+    }
+    try {
+      regexes_.emplace_back(k, utils::Regex(value, rgx_mode));
+    } catch (const Exception &e) {
+      logger_->log_error("%s error encountered when trying to construct regular expression from property (key: %s) value: %s",
+                         e.what(), k, value);
+    }
+  }
+}
+
 void ExtractText::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
   std::shared_ptr<core::FlowFile> flowFile = session->get();
 
@@ -107,7 +134,7 @@ void ExtractText::onTrigger(core::ProcessContext *context, core::ProcessSession
     return;
   }
 
-  ReadCallback cb(flowFile, context, logger_);
+  ReadCallback cb(flowFile, context, regexes_, logger_);
   session->read(flowFile, &cb);
   session->transfer(flowFile, Success);
 }
@@ -128,98 +155,101 @@ int64_t ExtractText::ReadCallback::process(const std::shared_ptr<io::BaseStream>
   else if (sizeLimitStr != "0")
     size_limit = std::stoi(sizeLimitStr);
 
-  std::ostringstream contentStream;
+  const uint8_t* view;
+  size_t view_size;
+  if (stream->getUnreadView(view, view_size)) {
+    // the content is already in memory, take it without any copy
+    read_size = std::min<uint64_t>(size_limit, view_size);
+    const char* begin = reinterpret_cast<const char*>(view);
+    if (regex_mode) {
+      extractMatches(begin, begin + read_size);
+    } else {
+      flowFile_->setAttribute(attrKey, std::string(begin, gsl::narrow<size_t>(read_size)));
+    }
+    return read_size;
+  }
 
+  std::string contentStr;
+  contentStr.reserve(gsl::narrow<size_t>(std::min(size_limit, flowFile_->getSize())));
   while (read_size < size_limit) {
     // Don't read more than config limit or the size of the buffer
-    int length = gsl::narrow<int>(std::min<uint64_t>(size_limit - read_size, buffer_.size()));
-    ret = stream->read(buffer_, length);
+    int length = gsl::narrow<int>(std::min<uint64_t>(size_limit - read_size, MAX_BUFFER_SIZE));
+    contentStr.resize(gsl::narrow<size_t>(read_size) + length);
+    ret = stream->read(reinterpret_cast<uint8_t*>(&contentStr[gsl::narrow<size_t>(read_size)]), length);
 
     if (ret < 0) {
       return -1;  // Stream error
     } else if (ret == 0) {
       break;  // End of stream, no more data
     }
-
-    contentStream.write(reinterpret_cast<const char*>(buffer_.data()), ret);
     read_size += ret;
-    if (contentStream.fail()) {
-      return -1;
-    }
   }
+  contentStr.resize(gsl::narrow<size_t>(read_size));
 
   if (regex_mode) {
-    std::vector<utils::Regex::Mode> rgx_mode;
-
-    bool insensitive;
-    if (ctx_->getProperty(InsensitiveMatch.getName(), insensitive) && insensitive) {
-      rgx_mode.push_back(utils::Regex::Mode::ICASE);
-    }
-
-    bool ignoregroupzero;
-    ctx_->getProperty(IgnoreCaptureGroupZero.getName(), ignoregroupzero);
-
-    bool repeatingcapture;
-    ctx_->getProperty(EnableRepeatingCaptureGroup.getName(), repeatingcapture);
-
-    int maxCaptureSizeProperty;
-    ctx_->getProperty(MaxCaptureGroupLen.getName(), maxCaptureSizeProperty);
-    size_t maxCaptureSize = gsl::narrow<size_t>(maxCaptureSizeProperty);
+    extractMatches(contentStr.data(), contentStr.data() + contentStr.size());
+  } else {
+    flowFile_->setAttribute(attrKey, std::move(contentStr));
+  }
+  return read_size;
+}
 
-    std::string contentStr = contentStream.str();
+void ExtractText::ReadCallback::extractMatches(const char *begin, const char *end) {
+  bool ignoregroupzero;
+  ctx_->getProperty(IgnoreCaptureGroupZero.getName(), ignoregroupzero);
 
-    std::map<std::string, std::string> regexAttributes;
+  bool repeatingcapture;
+  ctx_->getProperty(EnableRepeatingCaptureGroup.getName(), repeatingcapture);
 
-    for (const auto& k : ctx_->getDynamicPropertyKeys()) {
-      std::string value;
-      ctx_->getDynamicProperty(k, value);
+  int maxCaptureSizeProperty;
+  ctx_->getProperty(MaxCaptureGroupLen.getName(), maxCaptureSizeProperty);
+  const auto maxCaptureSize = gsl::narrow<std::ptrdiff_t>(maxCaptureSizeProperty);
 
-      std::string workStr = contentStr;
+  std::map<std::string, std::string> regexAttributes;
+  std::vector<std::pair<const char*, const char*>> matches;
 
-      int matchcount = 0;
+  // every regex searches the same content, without copying it
+  for (const auto& regex : regexes_) {
+    const std::string& k = regex.first;
+    int matchcount = 0;
+    const char* search_begin = begin;
 
-      try {
-        utils::Regex rgx(value, rgx_mode);
-        while (rgx.match(workStr)) {
-          const std::vector<std::string> &matches = rgx.getResult();
-          size_t i = ignoregroupzero ? 1 : 0;
+    while (regex.second.search(search_begin, end, matches)) {
+      size_t i = ignoregroupzero ? 1 : 0;
 
-          for (; i < matches.size(); ++i, ++matchcount) {
-            std::string attributeValue = matches[i];
-            if (attributeValue.length() > maxCaptureSize) {
-              attributeValue = attributeValue.substr(0, maxCaptureSize);
-            }
-            if (matchcount == 0) {
-              regexAttributes[k] = attributeValue;
-            }
-            regexAttributes[k + '.' + std::to_string(matchcount)] = attributeValue;
-          }
-          if (!repeatingcapture) {
-            break;
-          }
-          workStr = rgx.getSuffix();
+      for (; i < matches.size(); ++i, ++matchcount) {
+        const auto& match = matches[i];
+        std::string attributeValue(match.first, match.first + std::min(match.second - match.first, maxCaptureSize));
+        if (matchcount == 0) {
+          regexAttributes[k] = attributeValue;
         }
-      } catch (const Exception &e) {
-        logger_->log_error("%s error encountered when trying to construct regular expression from property (key: %s) value: %s",
-                           e.what(), k, value);
-        continue;
+        regexAttributes[k + '.' + std::to_string(matchcount)] = std::move(attributeValue);
+      }
+      if (!repeatingcapture) {
+        break;
+      }
+      if (matches[0].second != matches[0].first) {
+        search_begin = matches[0].second;
+      } else if (matches[0].second != end) {
+        // continue after an empty match, instead of finding it again
+        search_begin = matches[0].second + 1;
+      } else {
+        break;
       }
     }
+  }
 
-    for (const auto& kv : regexAttributes) {
-      flowFile_->setAttribute(kv.first, kv.second);
-    }
-  } else {
-    flowFile_->setAttribute(attrKey, contentStream.str());
+  for (const auto& kv : regexAttributes) {
+    flowFile_->setAttribute(kv.first, kv.second);
   }
-  return read_size;
 }
 
-ExtractText::ReadCallback::ReadCallback(std::shared_ptr<core::FlowFile> flowFile, core::ProcessContext *ctx,  std::shared_ptr<logging::Logger> lgr)
+ExtractText::ReadCallback::ReadCallback(std::shared_ptr<core::FlowFile> flowFile, core::ProcessContext *ctx,
+                                        const std::vector<std::pair<std::string, utils::Regex>> &regexes, std::shared_ptr<logging::Logger> lgr)
     : flowFile_(std::move(flowFile)),
       ctx_(ctx),
+      regexes_(regexes),
       logger_(std::move(lgr)) {
-  buffer_.resize(std::min(gsl::narrow<size_t>(flowFile_->getSize()), MAX_BUFFER_SIZE));
 }
 
 }  // namespace processors
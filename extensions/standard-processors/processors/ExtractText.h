@@ -22,12 +22,14 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
 #include "core/Resource.h"
 #include "FlowFileRecord.h"
+#include "utils/RegexUtils.h"
 
 namespace org {
 namespace apache {
@@ -63,6 +65,8 @@ class ExtractText : public core::Processor {
     //! Default maximum bytes to read into an attribute
     static constexpr int DEFAULT_SIZE_LIMIT = 2 * 1024 * 1024;
 
+    //! OnSchedule method, compiles the regular expressions of the dynamic properties
+    void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) override;
     //! OnTrigger method, implemented by NiFi ExtractText
     void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
     //! Initialize, over write by NiFi ExtractText
@@ -74,18 +78,24 @@ class ExtractText : public core::Processor {
 
     class ReadCallback : public InputStreamCallback {
      public:
-        ReadCallback(std::shared_ptr<core::FlowFile> flowFile, core::ProcessContext *ct, std::shared_ptr<logging::Logger> lgr);
+        ReadCallback(std::shared_ptr<core::FlowFile> flowFile, core::ProcessContext *ct, const std::vector<std::pair<std::string, utils::Regex>> &regexes,
+                     std::shared_ptr<logging::Logger> lgr);
         ~ReadCallback() = default;
         int64_t process(const std::shared_ptr<io::BaseStream>& stream);
 
      private:
+        void extractMatches(const char *begin, const char *end);
+
         std::shared_ptr<core::FlowFile> flowFile_;
         core::ProcessContext *ctx_;
-        std::vector<uint8_t> buffer_;
+        const std::vector<std::pair<std::string, utils::Regex>> &regexes_;
         std::shared_ptr<logging::Logger> logger_;
     };
 
  private:
+    //! Compiled regular expressions of the dynamic properties, by property name. Only read while triggered, so they are shared by the concurrent tasks.
+    std::vector<std::pair<std::string, utils::Regex>> regexes_;
+
     //! Logger
     std::shared_ptr<logging::Logger> logger_;
 };
@@ -47,21 +47,32 @@ using HashReturnType = std::pair<std::string, int64_t>;
 namespace { // NOLINT
 #define HASH_BUFFER_SIZE 16384
 
+  // Feeds the unread content of the stream to update, straight from memory when the stream has a view of it
+  template<typename Update>
+  int64_t HashStream(const std::shared_ptr<org::apache::nifi::minifi::io::BaseStream>& stream, Update update) {
+    const uint8_t* view;
+    size_t view_size;
+    if (stream->getUnreadView(view, view_size)) {
+      update(view, view_size);
+      return view_size;
+    }
+
+    uint8_t buffer[HASH_BUFFER_SIZE];
+    int64_t read_size = 0;
+    int ret;
+    while ((ret = stream->read(buffer, HASH_BUFFER_SIZE)) > 0) {
+      update(buffer, ret);
+      read_size += ret;
+    }
+    return read_size;
+  }
+
   HashReturnType MD5Hash(const std::shared_ptr<org::apache::nifi::minifi::io::BaseStream>& stream) {
     HashReturnType ret_val;
-    ret_val.second = 0;
-    uint8_t buffer[HASH_BUFFER_SIZE];
     MD5_CTX context;
     MD5_Init(&context);
 
-    size_t ret = 0;
-    do {
-      ret = stream->read(buffer, HASH_BUFFER_SIZE);
-      if (ret > 0) {
-        MD5_Update(&context, buffer, ret);
-        ret_val.second += ret;
-      }
-    } while (ret > 0);
+    ret_val.second = HashStream(stream, [&context](const uint8_t* data, size_t len) { MD5_Update(&context, data, len); });
 
     if (ret_val.second > 0) {
       unsigned char digest[MD5_DIGEST_LENGTH];
@@ -73,19 +84,10 @@ namespace { // NOLINT
 
   HashReturnType SHA1Hash(const std::shared_ptr<org::apache::nifi::minifi::io::BaseStream>& stream) {
     HashReturnType ret_val;
-    ret_val.second = 0;
-    uint8_t buffer[HASH_BUFFER_SIZE];
     SHA_CTX context;
     SHA1_Init(&context);
 
-    size_t ret = 0;
-    do {
-      ret = stream->read(buffer, HASH_BUFFER_SIZE);
-      if (ret > 0) {
-        SHA1_Update(&context, buffer, ret);
-        ret_val.second += ret;
-      }
-    } while (ret > 0);
+    ret_val.second = HashStream(stream, [&context](const uint8_t* data, size_t len) { SHA1_Update(&context, data, len); });
 
     if (ret_val.second > 0) {
       unsigned char digest[SHA_DIGEST_LENGTH];
@@ -97,19 +99,10 @@ namespace { // NOLINT
 
   HashReturnType SHA256Hash(const std::shared_ptr<org::apache::nifi::minifi::io::BaseStream>& stream) {
     HashReturnType ret_val;
-    ret_val.second = 0;
-    uint8_t buffer[HASH_BUFFER_SIZE];
     SHA256_CTX context;
     SHA256_Init(&context);
 
-    size_t ret;
-    do {
-      ret = stream->read(buffer, HASH_BUFFER_SIZE);
-      if (ret > 0) {
-        SHA256_Update(&context, buffer, ret);
-        ret_val.second += ret;
-      }
-    } while (ret > 0);
+    ret_val.second = HashStream(stream, [&context](const uint8_t* data, size_t len) { SHA256_Update(&context, data, len); });
 
     if (ret_val.second > 0) {
       unsigned char digest[SHA256_DIGEST_LENGTH];
@@ -19,6 +19,7 @@
  */
 #include "ListenSyslog.h"
 #include <stdio.h>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -113,6 +114,7 @@ void ListenSyslog::runThread() {
         close(clientSocket);
       }
       _clientSockets.clear();
+      _selector.clear();
       if (_serverSocket > 0) {
         close(_serverSocket);
         _serverSocket = 0;
@@ -143,74 +145,52 @@ void ListenSyslog::runThread() {
         listen(sockfd, 5);
       _serverSocket = sockfd;
       logger_->log_info("ListenSysLog Server socket %d bind OK to port %d", _serverSocket, portno);
+      if (!_selector.add(_serverSocket)) {
+        logger_->log_error("ListenSysLog Server socket %d could not be watched", _serverSocket);
+        break;
+      }
     }
-    FD_ZERO(&_readfds);
-    FD_SET(_serverSocket, &_readfds);
-    _maxFds = _serverSocket;
-    std::vector<int>::iterator it;
-    for (it = _clientSockets.begin(); it != _clientSockets.end(); ++it) {
-      int clientSocket = *it;
-      if (clientSocket >= _maxFds)
-        _maxFds = clientSocket;
-      FD_SET(clientSocket, &_readfds);
-    }
-    fd_set fds;
-    struct timeval tv;
-    int retval;
-    fds = _readfds;
-    tv.tv_sec = 0;
     // 100 msec
-    tv.tv_usec = 100000;
-    retval = select(_maxFds + 1, &fds, NULL, NULL, &tv);
-    if (retval < 0)
-      break;
-    if (retval == 0)
-      continue;
-    if (FD_ISSET(_serverSocket, &fds)) {
-      // server socket, either we have UDP datagram or TCP connection request
-      if (_protocol == "TCP") {
-        socklen_t clilen;
-        struct sockaddr_in cli_addr;
-        clilen = sizeof(cli_addr);
-        int newsockfd = accept(_serverSocket, reinterpret_cast<struct sockaddr *>(&cli_addr), &clilen);
-        if (newsockfd > 0) {
-          if (_clientSockets.size() < (uint64_t) _maxConnections) {
-            _clientSockets.push_back(newsockfd);
-            logger_->log_info("ListenSysLog new client socket %d connection", newsockfd);
-            continue;
-          } else {
-            close(newsockfd);
+    const auto ready = _selector.wait(std::chrono::milliseconds(100));
+    for (const int fd : ready) {
+      if (fd == _serverSocket) {
+        // server socket, either we have UDP datagram or TCP connection request
+        if (_protocol == "TCP") {
+          socklen_t clilen;
+          struct sockaddr_in cli_addr;
+          clilen = sizeof(cli_addr);
+          int newsockfd = accept(_serverSocket, reinterpret_cast<struct sockaddr *>(&cli_addr), &clilen);
+          if (newsockfd > 0) {
+            if (_clientSockets.size() < (uint64_t) _maxConnections && _selector.add(newsockfd)) {
+              _clientSockets.push_back(newsockfd);
+              logger_->log_info("ListenSysLog new client socket %d connection", newsockfd);
+            } else {
+              close(newsockfd);
+            }
           }
-        }
-      } else {
-        socklen_t clilen;
-        struct sockaddr_in cli_addr;
-        clilen = sizeof(cli_addr);
-        int recvlen = recvfrom(_serverSocket, _buffer, sizeof(_buffer), 0, (struct sockaddr *) &cli_addr, &clilen);
-        if (recvlen > 0 && (uint64_t) (recvlen + getEventQueueByteSize()) <= _recvBufSize) {
-          uint8_t *payload = new uint8_t[recvlen];
-          memcpy(payload, _buffer, recvlen);
-          putEvent(payload, recvlen);
-        }
-      }
-    }
-    it = _clientSockets.begin();
-    while (it != _clientSockets.end()) {
-      int clientSocket = *it;
-      if (FD_ISSET(clientSocket, &fds)) {
-        int recvlen = readline(clientSocket, _buffer, sizeof(_buffer));
-        if (recvlen <= 0) {
-          close(clientSocket);
-          logger_->log_debug("ListenSysLog client socket %d close", clientSocket);
-          it = _clientSockets.erase(it);
         } else {
-          if ((uint64_t) (recvlen + getEventQueueByteSize()) <= _recvBufSize) {
+          socklen_t clilen;
+          struct sockaddr_in cli_addr;
+          clilen = sizeof(cli_addr);
+          int recvlen = recvfrom(_serverSocket, _buffer, sizeof(_buffer), 0, (struct sockaddr *) &cli_addr, &clilen);
+          if (recvlen > 0 && (uint64_t) (recvlen + getEventQueueByteSize()) <= _recvBufSize) {
             uint8_t *payload = new uint8_t[recvlen];
             memcpy(payload, _buffer, recvlen);
             putEvent(payload, recvlen);
           }
-          ++it;
         }
+        continue;
+      }
+      int recvlen = readline(fd, _buffer, sizeof(_buffer));
+      if (recvlen <= 0) {
+        _selector.remove(fd);
+        close(fd);
+        logger_->log_debug("ListenSysLog client socket %d close", fd);
+        _clientSockets.erase(std::remove(_clientSockets.begin(), _clientSockets.end(), fd), _clientSockets.end());
+      } else if ((uint64_t) (recvlen + getEventQueueByteSize()) <= _recvBufSize) {
+        uint8_t *payload = new uint8_t[recvlen];
+        memcpy(payload, _buffer, recvlen);
+        putEvent(payload, recvlen);
       }
     }
   }
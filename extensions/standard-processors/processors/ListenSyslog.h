@@ -31,7 +31,6 @@
 #ifndef WIN32
 #include <arpa/inet.h>
 #include <netinet/in.h>
-#include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/time.h>
 
@@ -50,6 +49,7 @@
 #include "core/ProcessSession.h"
 #include "core/Resource.h"
 #include "FlowFileRecord.h"
+#include "io/SocketSelector.h"
 
 #ifndef WIN32
 
@@ -87,8 +87,6 @@ class ListenSyslog : public core::Processor {
     _port = 514;
     _parseMessages = false;
     _serverSocket = 0;
-    _maxFds = 0;
-    FD_ZERO(&_readfds);
     _thread = NULL;
     _resetServerSocket = false;
     _serverTheadRunning = false;
@@ -211,8 +209,8 @@ class ListenSyslog : public core::Processor {
   bool _parseMessages;
   int _serverSocket;
   std::vector<int> _clientSockets;
-  int _maxFds;
-  fd_set _readfds;
+  // the server socket and the TCP client sockets
+  io::SocketSelector _selector;
   // thread
   std::thread *_thread;
   // whether to reset the server socket
@@ -181,3 +181,44 @@ TEST_CASE("Test usage of ExtractText in regex mode", "[extracttextRegexTest]") {
 
   LogTestController::getInstance().reset();
 }
+
+TEST_CASE("ExtractText applies every regex to the same content", "[extracttextMultipleRegexTest]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<org::apache::nifi::minifi::processors::LogAttribute>();
+
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+
+  char dirtemplate[] = "/tmp/gt.XXXXXX";
+
+  auto dir = testController.createTempDirectory(dirtemplate);
+  REQUIRE(!dir.empty());
+  std::shared_ptr<core::Processor> getfile = plan->addProcessor("GetFile", "getfileCreate2");
+  plan->setProperty(getfile, org::apache::nifi::minifi::processors::GetFile::Directory.getName(), dir);
+  plan->setProperty(getfile, org::apache::nifi::minifi::processors::GetFile::KeepSourceFile.getName(), "true");
+
+  std::shared_ptr<core::Processor> maprocessor = plan->addProcessor("ExtractText", "testExtractText", core::Relationship("success", "description"), true);
+  plan->setProperty(maprocessor, org::apache::nifi::minifi::processors::ExtractText::RegexMode.getName(), "true");
+  plan->setProperty(maprocessor, org::apache::nifi::minifi::processors::ExtractText::InsensitiveMatch.getName(), "true");
+  plan->setProperty(maprocessor, org::apache::nifi::minifi::processors::ExtractText::MaxCaptureGroupLen.getName(), "2");
+  plan->setProperty(maprocessor, "FirstLimit", "SPEED LIMIT ([0-9]+)", true);
+  plan->setProperty(maprocessor, "LastLimit", "([0-9]+)$", true);
+
+  std::shared_ptr<core::Processor> laprocessor = plan->addProcessor("LogAttribute", "outputLogAttribute", core::Relationship("success", "description"), true);
+
+  std::ofstream test_file(dir + utils::file::FileUtils::get_separator() + TEST_FILE);
+  if (test_file.is_open()) {
+    test_file << REGEX_TEST_TEXT;
+    test_file.close();
+  }
+
+  plan->runNextProcessor();  // GetFile
+  plan->runNextProcessor();  // ExtractText
+  plan->runNextProcessor();  // LogAttribute
+
+  REQUIRE(LogTestController::getInstance().contains("key:FirstLimit value:13"));
+  REQUIRE(LogTestController::getInstance().contains("key:FirstLimit.0 value:13"));
+  REQUIRE(LogTestController::getInstance().contains("key:LastLimit value:80"));
+  REQUIRE(LogTestController::getInstance().contains("value:130", std::chrono::seconds(0)) == false);
+
+  LogTestController::getInstance().reset();
+}
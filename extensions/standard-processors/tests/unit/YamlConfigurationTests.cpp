@@ -162,6 +162,7 @@ TEST_CASE("Test YAML Config Processing", "[YamlConfiguration]") {
     REQUIRE(it.second->getDestination());
     REQUIRE(it.second->getSource());
     REQUIRE(60000 == it.second->getFlowExpirationDuration());
+    REQUIRE(std::dynamic_pointer_cast<core::NewestFlowFileFirstPrioritizer>(it.second->getPrioritizer()));
   }
 }
 
@@ -29,11 +29,13 @@
 #include <mutex>
 #include <atomic>
 #include <algorithm>
+#include "concurrentqueue.h"
 #include "core/Core.h"
 #include "core/Connectable.h"
 #include "core/logging/Logger.h"
 #include "core/Relationship.h"
 #include "core/FlowFile.h"
+#include "core/FlowFilePrioritizer.h"
 #include "core/Repository.h"
 
 namespace org {
@@ -140,14 +142,25 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
     return drop_empty_;
   }
 
+  /**
+   * Sets the prioritizer deciding the order in which flow files are handed out,
+   * nullptr means first in first out. Must be set before flow files are queued.
+   */
+  void setPrioritizer(const std::shared_ptr<core::FlowFilePrioritizer>& prioritizer) {
+    prioritizer_ = prioritizer;
+  }
+
+  std::shared_ptr<core::FlowFilePrioritizer> getPrioritizer() const {
+    return prioritizer_;
+  }
+
   // Check whether the queue is empty
   bool isEmpty();
   // Check whether the queue is full to apply back pressure
   bool isFull();
   // Get queue size
   uint64_t getQueueSize() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.size();
+    return queued_count_;
   }
   // Get queue data size
   uint64_t getQueueDataSize() {
@@ -159,16 +172,25 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
 
   // Put multiple flowfiles into the queue
   void multiPut(std::vector<std::shared_ptr<core::FlowFile>>& flows);
+
+  void multiRestore(std::vector<std::shared_ptr<core::FlowFile>>& flows) override {
+    multiPut(flows);
+  }
   // Poll the flow file from queue, the expired flow file record also being returned
   std::shared_ptr<core::FlowFile> poll(std::set<std::shared_ptr<core::FlowFile>> &expiredFlowRecords);
+  /**
+   * Polls multiple flow files from the queue at once, the expired flow file records also being returned.
+   * @param max_count maximum number of flow files to return
+   * @param max_bytes no more flow files are taken once their total size reaches this, 0 means no limit
+   * @param expiredFlowRecords receives the flow files that expired while queued
+   */
+  std::vector<std::shared_ptr<core::FlowFile>> pollBatch(size_t max_count, uint64_t max_bytes, std::set<std::shared_ptr<core::FlowFile>> &expiredFlowRecords);
   // Drain the flow records
   void drain(bool delete_permanently);
 
   void yield() override {}
 
-  bool isWorkAvailable() override {
-    return !isEmpty();
-  }
+  bool isWorkAvailable() override;
 
   bool isRunning() override {
     return true;
@@ -197,13 +219,59 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
   std::shared_ptr<core::ContentRepository> content_repo_;
 
  private:
+  // Flow file in the priority heap along with its position in the arrival order
+  struct PrioritizedFlowFile {
+    std::shared_ptr<core::FlowFile> flow;
+    uint64_t sequence;
+  };
+
+  // Pushes the flow file into the queue
+  void push(const std::shared_ptr<core::FlowFile>& flow);
+  // Pops the flow file to be handed out next from the queue if there is any
+  bool pop(std::shared_ptr<core::FlowFile>& flow);
+  // Pops the flow file on top of the priority heap if there is any, priority_mutex_ must be held
+  bool popPrioritized(std::shared_ptr<core::FlowFile>& flow);
+  // Tells whether lhs comes after rhs in the order defined by the prioritizer
+  bool isHandedOutLater(const PrioritizedFlowFile& lhs, const PrioritizedFlowFile& rhs) const;
+  // Pushes the flow file into the queue and accounts for it in the counters
+  void enqueue(const std::shared_ptr<core::FlowFile>& flow);
+  // Pops a flow file from the queue if there is any and accounts for it in the counters
+  bool dequeue(std::shared_ptr<core::FlowFile>& flow);
+  // Parks a penalized flow file until its penalty expires
+  void penalize(const std::shared_ptr<core::FlowFile>& flow);
+  // Moves the flow files whose penalty has expired back into the queue
+  void releaseExpiredPenalties(uint64_t now);
+
+  // Orders the penalty heap so that the flow file whose penalty expires first is on top
+  struct PenaltyExpiresLater {
+    bool operator()(const std::shared_ptr<core::FlowFile>& lhs, const std::shared_ptr<core::FlowFile>& rhs) const {
+      return lhs->getPenaltyExpiration() > rhs->getPenaltyExpiration();
+    }
+  };
+
   bool drop_empty_;
-  // Mutex for protection
-  std::mutex mutex_;
+  // Number of queued flow files; never less than the number of flow files actually queued
+  std::atomic<uint64_t> queued_count_;
   // Queued data size
   std::atomic<uint64_t> queued_data_size_;
-  // Queue for the Flow File
-  std::queue<std::shared_ptr<core::FlowFile>> queue_;
+  // Lock-free queue for the Flow File, FIFO with respect to each producing thread
+  moodycamel::ConcurrentQueue<std::shared_ptr<core::FlowFile>> queue_;
+  // Prioritizer of the connection, if set the priority heap is used instead of the lock-free queue
+  std::shared_ptr<core::FlowFilePrioritizer> prioritizer_;
+  // Mutex for protection of the priority heap
+  std::mutex priority_mutex_;
+  // Priority heap for the Flow File, the one to be handed out next is on top
+  std::vector<PrioritizedFlowFile> prioritized_;
+  // Arrival counter breaking ties between flow files of equal priority
+  uint64_t next_sequence_;
+  // Mutex for protection of the penalty heap
+  std::mutex penalty_mutex_;
+  // Penalized flow files, these are included in queued_count_ and queued_data_size_
+  std::priority_queue<std::shared_ptr<core::FlowFile>, std::vector<std::shared_ptr<core::FlowFile>>, PenaltyExpiresLater> penalized_;
+  // Number of penalized flow files
+  std::atomic<uint64_t> penalized_count_;
+  // Earliest penalty expiration in the penalty heap, only meaningful if penalized_count_ > 0
+  std::atomic<uint64_t> next_penalty_expiration_;
   // flow repository
   // Logger
   std::shared_ptr<logging::Logger> logger_;
@@ -24,6 +24,7 @@
 #include <string>
 
 #define DEFAULT_TIME_SLICE_MS 500
+#define DEFAULT_MAX_WAIT_FOR_WORK_MS 1000
 
 #include "core/logging/Logger.h"
 #include "core/Processor.h"
@@ -56,6 +57,8 @@ class EventDrivenSchedulingAgent : public ThreadedSchedulingAgent {
 
   void schedule(std::shared_ptr<core::Processor> processor) override;
 
+  void unschedule(std::shared_ptr<core::Processor> processor) override;
+
   // Run function for the thread
   utils::TaskRescheduleInfo run(const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<core::ProcessContext> &processContext,
       const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) override;
@@ -52,6 +52,12 @@ namespace core {
 class ProcessSession;
 }
 
+/**
+ * Persisted records are written in format version 2: a marker byte, the version, varint encoded
+ * numbers and lengths, binary uuids, the keys of well known attributes as indices into a fixed
+ * dictionary and the content claim relative to the storage path of the content repository.
+ * Records of the original format, which starts with the event time, are still read.
+ */
 class FlowFileRecord : public core::FlowFile {
   friend class core::ProcessSession;
 
@@ -77,6 +83,11 @@ class FlowFileRecord : public core::FlowFile {
     return claim_ ? claim_->getContentFullPath() : "";
   }
 
+ private:
+  static std::shared_ptr<FlowFileRecord> DeSerializeV1(uint8_t first_byte, io::InputStream &stream, const std::shared_ptr<core::ContentRepository> &content_repo, utils::Identifier& container);
+
+  static std::shared_ptr<FlowFileRecord> DeSerializeV2(io::InputStream &stream, const std::shared_ptr<core::ContentRepository> &content_repo, utils::Identifier& container);
+
  protected:
   // Local flow sequence ID
   static std::atomic<uint64_t> local_flow_seq_number_;
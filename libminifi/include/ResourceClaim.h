@@ -78,6 +78,17 @@ class ResourceClaim {
     return _contentFullPath;
   }
 
+  /**
+   * Returns the path of the content relative to the directory its claim manager creates claims in,
+   * or an empty path if the content is stored elsewhere.
+   */
+  Path getRelativePath() const;
+
+  /**
+   * Returns the directory new claims of the claim manager are created in.
+   */
+  static Path getContentDirectory(const std::shared_ptr<core::StreamManager<ResourceClaim>>& claim_manager);
+
   bool exists() {
     if (claim_manager_ == nullptr) {
       return false;
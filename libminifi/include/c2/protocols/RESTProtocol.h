@@ -58,7 +58,7 @@ namespace c2 {
 
 struct ValueObject {
   std::string name;
-  std::vector<rapidjson::Value*> values;
+  std::vector<rapidjson::Value> values;
 };
 
 class RESTProtocol {
@@ -80,6 +80,11 @@ class RESTProtocol {
    */
   virtual rapidjson::Value serializeConnectionQueues(const C2Payload &payload, std::string &label, rapidjson::Document::AllocatorType &alloc);
 
+  /**
+   * Serializes the payload into compact JSON. The nested payloads are serialized one at a time, straight into
+   * the output, so only one of them is held as a JSON document at any time. With minimize_updates_, the nested
+   * payloads whose serialized form did not change since they were last sent are left out.
+   */
   virtual std::string serializeJsonRootPayload(const C2Payload& payload);
 
   virtual void mergePayloadContent(rapidjson::Value &target, const C2Payload &payload, rapidjson::Document::AllocatorType &alloc);
@@ -90,11 +95,10 @@ class RESTProtocol {
 
   virtual Operation stringToOperation(const std::string str);
 
-  bool containsPayload(const C2Payload &o);
-
   std::mutex update_mutex_;
   bool minimize_updates_;
-  std::map<std::string, C2Payload> nested_payloads_;
+  // hashes of the last sent form of the nested payloads, by label
+  std::map<std::string, size_t> nested_payload_hashes_;
 };
 
 }  // namespace c2
@@ -28,6 +28,7 @@
 #include <unordered_map>
 #include "Core.h"
 #include <condition_variable>
+#include <functional>
 #include "core/logging/Logger.h"
 #include "Relationship.h"
 #include "Scheduling.h"
@@ -88,6 +89,15 @@ class Connectable : public CoreComponent {
     put(file);
   }
 
+  /**
+   * Restores the flow files recovered from the repository at once.
+   */
+  virtual void multiRestore(std::vector<std::shared_ptr<FlowFile>>& files) {
+    for (const auto& file : files) {
+      restore(file);
+    }
+  }
+
   /**
    * Gets and sets next incoming connection
    * @return next incoming connection
@@ -133,6 +143,13 @@ class Connectable : public CoreComponent {
 
   void notifyWork();
 
+  /**
+   * Sets the callback invoked by notifyWork when work becomes available, allowing
+   * an event driven scheduler to wake up this connectable instead of polling it.
+   * @param notifier callback, or an empty function to remove it
+   */
+  void setWorkNotifier(std::function<void()> notifier);
+
   /**
    * Determines if work is available by this connectable
    * @return boolean if work is available.
@@ -197,6 +214,8 @@ class Connectable : public CoreComponent {
   std::atomic<SchedulingStrategy> strategy_;
   // Concurrent condition variable for whether there is incoming work to do
   std::condition_variable work_condition_;
+  // Callback to wake up the scheduler when there is incoming work to do, guarded by work_available_mutex_
+  std::function<void()> work_notifier_;
   // version under which this connectable was created.
   std::shared_ptr<state::FlowIdentifier> connectable_version_;
 
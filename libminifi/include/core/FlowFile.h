@@ -156,25 +156,39 @@ class FlowFile : public CoreComponent, public ReferenceContainer {
    * setAttribute, if attribute already there, update it, else, add it
    */
   bool setAttribute(const std::string& key, const std::string& value) {
-    return attributes_.insert_or_assign(key, value).second;
+    return mutableAttributes().insert_or_assign(key, value).second;
   }
 
   /**
-   * Returns the map of attributes
+   * Returns the map of attributes, which is only valid until the attributes are modified
    * @return attributes.
    */
-  std::map<std::string, std::string> getAttributes() const {
-    return {attributes_.begin(), attributes_.end()};
+  const AttributeMap& getAttributes() const {
+    return *attributes_;
   }
 
   /**
-   * Returns the map of attributes
+   * Returns a snapshot of the attributes. The map is shared with the flow file, which
+   * copies it before the next modification.
+   */
+  std::shared_ptr<const AttributeMap> shareAttributes() const;
+
+  /**
+   * Returns the map of attributes for modification. The map is no longer shared
+   * with any other flow file afterwards.
    * @return attributes.
    */
   AttributeMap *getAttributesPtr() {
-    return &attributes_;
+    attributes_exposed_ = true;
+    return &mutableAttributes();
   }
 
+  /**
+   * Takes the attributes of other, keeping the ones of this flow file that other doesn't have.
+   * The attributes are shared with other until either of the flow files modifies them.
+   */
+  void inheritAttributes(const FlowFile& other);
+
   /**
    * adds an attribute if it does not exist
    *
@@ -249,6 +263,11 @@ class FlowFile : public CoreComponent, public ReferenceContainer {
   }
 
  protected:
+  /**
+   * Returns the attributes for modification, copying them first if they are shared.
+   */
+  AttributeMap& mutableAttributes();
+
   bool stored;
   // Mark for deletion
   bool marked_delete_;
@@ -269,8 +288,14 @@ class FlowFile : public CoreComponent, public ReferenceContainer {
   uint64_t offset_;
   // Penalty expiration
   uint64_t penaltyExpiration_ms_;
-  // Attributes key/values pairs for the flow record
-  AttributeMap attributes_;
+  // Attributes key/values pairs for the flow record, shared between copies of the flow file
+  // until one of them modifies it
+  std::shared_ptr<AttributeMap> attributes_;
+  // the attributes were handed out for modification, so they are never shared
+  bool attributes_exposed_;
+  // the attributes were shared, so they have to be copied before they are modified; set from const
+  // members too, as sharing doesn't change the attributes
+  mutable bool attributes_shared_;
   // Pointer to the associated content resource claim
   std::shared_ptr<ResourceClaim> claim_;
   // Pointers to stashed content resource claims
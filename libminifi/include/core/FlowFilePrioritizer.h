@@ -0,0 +1,87 @@
+/**
+ * @file FlowFilePrioritizer.h
+ * FlowFilePrioritizer class declaration
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_FLOWFILEPRIORITIZER_H_
+#define LIBMINIFI_INCLUDE_CORE_FLOWFILEPRIORITIZER_H_
+
+#include <memory>
+#include <string>
+
+#include "core/FlowFile.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+/**
+ * Decides the order in which the flow files queued in a connection are handed out,
+ * mirroring the FlowFile prioritizers of NiFi. Flow files that compare equal are
+ * handed out in the order they were queued.
+ */
+class FlowFilePrioritizer {
+ public:
+  virtual ~FlowFilePrioritizer() = default;
+
+  /**
+   * Compares two flow files.
+   * @return a negative number if lhs should be handed out before rhs, a positive number
+   * if rhs should be handed out before lhs, zero if they have the same priority
+   */
+  virtual int compare(const FlowFile& lhs, const FlowFile& rhs) const = 0;
+
+  /**
+   * Creates the prioritizer for the given class name. Both the NiFi class name
+   * (e.g. org.apache.nifi.prioritizer.OldestFlowFileFirstPrioritizer) and the simple
+   * class name are accepted.
+   * @return the prioritizer or nullptr for first in first out ordering, which needs no prioritizer
+   * @throws std::invalid_argument if the class name is not known
+   */
+  static std::shared_ptr<FlowFilePrioritizer> create(const std::string& class_name);
+};
+
+// Hands out the flow file whose lineage started first
+class OldestFlowFileFirstPrioritizer : public FlowFilePrioritizer {
+ public:
+  int compare(const FlowFile& lhs, const FlowFile& rhs) const override;
+};
+
+// Hands out the flow file whose lineage started last
+class NewestFlowFileFirstPrioritizer : public FlowFilePrioritizer {
+ public:
+  int compare(const FlowFile& lhs, const FlowFile& rhs) const override;
+};
+
+/**
+ * Orders flow files by their priority attribute: flow files with the attribute come first,
+ * numeric priorities precede textual ones, and lower values precede higher values.
+ */
+class PriorityAttributePrioritizer : public FlowFilePrioritizer {
+ public:
+  int compare(const FlowFile& lhs, const FlowFile& rhs) const override;
+};
+
+}  // namespace core
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_CORE_FLOWFILEPRIORITIZER_H_
@@ -76,6 +76,12 @@ class ProcessSession : public ReferenceContainer {
 
   // Get the FlowFile from the highest priority queue
   virtual std::shared_ptr<core::FlowFile> get();
+  /**
+   * Gets multiple FlowFiles at once, taking as many as possible from each incoming connection in turn.
+   * @param max_count maximum number of FlowFiles to get
+   * @param max_bytes no more FlowFiles are taken once their total size reaches this, 0 means no limit
+   */
+  virtual std::vector<std::shared_ptr<core::FlowFile>> get(size_t max_count, uint64_t max_bytes = 0);
   // Create a new UUID FlowFile with no content resource claim and inherit all attributes from parent
   std::shared_ptr<core::FlowFile> create(const std::shared_ptr<core::FlowFile> &parent = {});
   // Add a FlowFile to the session
@@ -174,6 +180,11 @@ class ProcessSession : public ReferenceContainer {
   void ensureNonNullResourceClaim(
       const std::map<std::shared_ptr<Connectable>, std::vector<std::shared_ptr<core::FlowFile>>>& transactionMap);
 
+  // Reports and deletes the FlowFiles that expired in an incoming connection
+  void removeExpiredFlowFiles(const std::set<std::shared_ptr<core::FlowFile>>& expired);
+  // Takes over a FlowFile polled from an incoming connection
+  void addPolledFlowFile(const std::shared_ptr<core::FlowFile>& flow, const std::shared_ptr<state::FlowIdentifier>& flow_version);
+
   // Clone the flow file during transfer to multiple connections for a relationship
   std::shared_ptr<core::FlowFile> cloneDuringTransfer(const std::shared_ptr<core::FlowFile> &parent);
   // ProcessContext
@@ -99,11 +99,26 @@ class Repository : public virtual core::SerializableComponent, public core::Trac
     return true;
   }
 
+  /**
+   * Stores the elements under their UUIDs. By default they are serialized on the calling thread and
+   * written with a single MultiPut. Repositories may serialize them in the background instead, so
+   * the elements must not be modified once stored.
+   */
+  virtual bool storeElements(const std::vector<std::shared_ptr<core::SerializableComponent>>& elements);
+
   // Delete
   virtual bool Delete(std::string key) {
     return true;
   }
 
+  /**
+   * Deletes the record stored under key. The content claim of the record is passed along,
+   * so that repositories owning a reference to it don't have to read the record back.
+   */
+  virtual bool Delete(const std::string &key, const std::shared_ptr<ResourceClaim>& /*claim*/) {
+    return Delete(key);
+  }
+
   virtual bool Delete(std::vector<std::shared_ptr<core::SerializableComponent>> &storedValues) {
     bool found = true;
     for (auto storedValue : storedValues) {
@@ -149,6 +164,15 @@ class Repository : public virtual core::SerializableComponent, public core::Trac
     return running_;
   }
 
+  /**
+   * Returns how long restoring the persisted records took at startup.
+   * @param millis receives the duration of the recovery in milliseconds
+   * @return false if the repository restores nothing or the recovery has not finished yet
+   */
+  virtual bool getRecoveryTime(uint64_t &millis) const {
+    return false;
+  }
+
   /**
    * Specialization that allows us to serialize max_size objects into store.
    * the lambdaConstructor will create objects to put into store
@@ -28,6 +28,9 @@ namespace org {
 namespace apache {
 namespace nifi {
 namespace minifi {
+namespace io {
+class OutputStream;
+}  // namespace io
 namespace core {
 
 /**
@@ -78,6 +81,15 @@ class SerializableComponent : public core::Connectable {
     return false;
   }
 
+  /**
+   * Serialization of this object into a stream
+   * @param outStream stream to which the serialized object is written
+   * @return status of serialization, false if the object can't be serialized into a stream
+   */
+  virtual bool Serialize(io::OutputStream &outStream) {
+    return false;
+  }
+
   virtual void yield() {
   }
 
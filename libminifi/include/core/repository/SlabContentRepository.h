@@ -0,0 +1,170 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_REPOSITORY_SLABCONTENTREPOSITORY_H_
+#define LIBMINIFI_INCLUDE_CORE_REPOSITORY_SLABCONTENTREPOSITORY_H_
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/Core.h"
+#include "../ContentRepository.h"
+#include "../ContentSession.h"
+#include "properties/Configure.h"
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+namespace repository {
+
+/**
+ * Content repository that appends the content of many claims to a few large segment files
+ * instead of creating a file per claim.
+ *
+ * Every write, append and removal of a claim is a record appended to the active segment;
+ * a claim is addressed by the list of (segment, offset, length) extents holding its content.
+ * The index is rebuilt by replaying the segments at startup. A segment file is deleted once
+ * no claim has content in it anymore and its removal records do not hide content in older
+ * segments.
+ */
+class SlabContentRepository : public core::ContentRepository, public core::CoreComponent {
+  class Session : public ContentSession {
+   public:
+    explicit Session(std::shared_ptr<ContentRepository> repository);
+
+    void commit() override;
+  };
+
+ public:
+  static constexpr uint64_t DEFAULT_MAX_SEGMENT_SIZE = 16 * 1024 * 1024;
+
+  explicit SlabContentRepository(std::string name = getClassName<SlabContentRepository>())
+      : core::CoreComponent(name),
+        max_segment_size_(DEFAULT_MAX_SEGMENT_SIZE),
+        active_segment_id_(0),
+        logger_(logging::LoggerFactory<SlabContentRepository>::getLogger()) {
+  }
+
+  ~SlabContentRepository() override {
+    stop();
+  }
+
+  bool initialize(const std::shared_ptr<minifi::Configure> &configuration) override;
+
+  void stop() override;
+
+  std::shared_ptr<ContentSession> createSession() override;
+
+  /**
+   * Creates a stream collecting the content of the claim, which is appended to the active
+   * segment when the stream is closed.
+   */
+  std::shared_ptr<io::BaseStream> write(const minifi::ResourceClaim &claim, bool append = false) override;
+
+  std::shared_ptr<io::BaseStream> read(const minifi::ResourceClaim &claim) override;
+
+  bool exists(const minifi::ResourceClaim &claim) override;
+
+  bool close(const minifi::ResourceClaim &claim) override {
+    return remove(claim);
+  }
+
+  bool remove(const minifi::ResourceClaim &claim) override;
+
+  /**
+   * Returns the number of segment files currently kept on disk.
+   */
+  size_t getSegmentCount() const;
+
+  struct Extent {
+    uint64_t segment;
+    uint64_t offset;
+    uint64_t length;
+  };
+
+  struct PendingWrite {
+    ResourceClaim::Path path;
+    bool append;
+    const uint8_t *data;
+    uint64_t length;
+  };
+
+  /**
+   * Appends the content of the given claims to the active segment and flushes it.
+   * @return false if the segment could not be written
+   */
+  bool append(const std::vector<PendingWrite> &writes);
+
+ private:
+  enum class RecordType : uint8_t {
+    WRITE = 0,
+    APPEND = 1,
+    REMOVE = 2
+  };
+
+  struct Segment {
+    uint64_t size = 0;
+    // number of extents of live claims stored in the segment
+    uint64_t references = 0;
+    // number of removal records in the segment that hide extents of older segments still on disk
+    uint64_t pending_tombstones = 0;
+    // segments whose removal records hide extents stored in this segment
+    std::vector<uint64_t> tombstone_segments;
+  };
+
+  std::string getSegmentPath(uint64_t segment_id) const;
+
+  void recover();
+
+  void replay(uint64_t segment_id, Segment &segment);
+
+  bool openActiveSegment(uint64_t segment_id);
+
+  bool writeRecord(RecordType type, const ResourceClaim::Path &path, const uint8_t *data, uint64_t length, uint64_t &data_offset);
+
+  void applyRecord(RecordType type, const ResourceClaim::Path &path, uint64_t segment_id, uint64_t data_offset, uint64_t length);
+
+  void dropExtents(const ResourceClaim::Path &path, uint64_t tombstone_segment_id);
+
+  void reclaimIfUnused(uint64_t segment_id);
+
+  uint64_t max_segment_size_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<ResourceClaim::Path, std::vector<Extent>> index_;
+  std::map<uint64_t, Segment> segments_;
+  uint64_t active_segment_id_;
+  std::ofstream active_segment_;
+
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+}  // namespace repository
+}  // namespace core
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_CORE_REPOSITORY_SLABCONTENTREPOSITORY_H_
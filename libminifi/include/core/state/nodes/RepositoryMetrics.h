@@ -85,6 +85,14 @@ class RepositoryMetrics : public ResponseNode {
       parent.children.push_back(datasizemax);
       parent.children.push_back(queuesize);
 
+      uint64_t recovery_time;
+      if (repo->getRecoveryTime(recovery_time)) {
+        SerializedResponseNode recoverytime;
+        recoverytime.name = "recoveryTimeMillis";
+        recoverytime.value = recovery_time;
+        parent.children.push_back(recoverytime);
+      }
+
       serialized.push_back(parent);
     }
     return serialized;
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <cstdint>
 #include <vector>
@@ -49,6 +50,13 @@ class BufferStream : public BaseStream {
 
   int read(uint8_t* buffer, int len) override;
 
+  bool getUnreadView(const uint8_t *&data, size_t &len) const override {
+    const size_t offset = (std::min<uint64_t>)(readOffset_, buffer_.size());
+    data = buffer_.data() + offset;
+    len = buffer_.size() - offset;
+    return true;
+  }
+
   int initialize() override {
     buffer_.clear();
     readOffset_ = 0;
@@ -0,0 +1,83 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LIBMINIFI_INCLUDE_IO_BUFFEREDSTREAM_H_
+#define LIBMINIFI_INCLUDE_IO_BUFFEREDSTREAM_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "BaseStream.h"
+#include "utils/gsl.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+/**
+ * Collects the writes to the underlying stream and passes them on in writes of up to the capacity of the buffer.
+ *
+ * Protocols which frame every field with a separate write would otherwise cost a syscall and a network packet each.
+ * The buffer is flushed when it is full, before reading from the stream (so that a request is sent before its
+ * response is awaited), on close, and when flush() is called.
+ */
+class BufferedStream : public BaseStream {
+ public:
+  static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+
+  explicit BufferedStream(gsl::not_null<BaseStream*> stream, size_t capacity = DEFAULT_CAPACITY);
+
+  BufferedStream(const BufferedStream&) = delete;
+  BufferedStream& operator=(const BufferedStream&) = delete;
+
+  using BaseStream::write;
+  using BaseStream::read;
+
+  int write(const uint8_t *value, int size) override;
+
+  int read(uint8_t *buf, int buflen) override;
+
+  /**
+   * Writes the buffered data to the underlying stream.
+   * @return 0 on success, -1 if the underlying stream failed
+   */
+  int flush() override;
+
+  size_t bufferedSize() const {
+    return buffer_.size();
+  }
+
+  void close() override;
+
+  int initialize() override;
+
+ private:
+  gsl::not_null<BaseStream*> stream_;
+  size_t capacity_;
+  std::vector<uint8_t> buffer_;
+};
+
+}  // namespace io
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_IO_BUFFEREDSTREAM_H_
@@ -43,6 +43,7 @@
 #include "io/validation.h"
 #include "properties/Configure.h"
 #include "io/NetworkPrioritizer.h"
+#include "io/SocketSelector.h"
 
 namespace org {
 namespace apache {
@@ -206,11 +207,12 @@ class Socket : public BaseStream {
 
   /**
    * Attempt to select the socket file descriptor
-   * @param msec timeout interval to wait
+   * @param msec timeout interval to wait, 0 waits indefinitely
    * @returns file descriptor
    */
   virtual int16_t select_descriptor(uint16_t msec);
 
+  // guards accepting connections and releasing them, the wait for readiness itself is not serialized
   std::recursive_mutex selection_mutex_;
 
   std::string requested_hostname_;
@@ -223,9 +225,8 @@ class Socket : public BaseStream {
   // connection information
   SocketDescriptor socket_file_descriptor_{ INVALID_SOCKET };  // -1 on posix
 
-  fd_set total_list_{};
-  fd_set read_fds_{};
-  std::atomic<uint16_t> socket_max_{ 0 };
+  // the listening socket and the connections accepted on it
+  SocketSelector selector_;
   std::atomic<uint64_t> total_written_{ 0 };
   std::atomic<uint64_t> total_read_{ 0 };
   uint16_t listeners_{ 0 };
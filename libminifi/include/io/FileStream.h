@@ -80,19 +80,31 @@ class FileStream : public io::BaseStream {
   int read(uint8_t *buf, int buflen) override;
 
   /**
-   * writes value to stream
+   * writes value to stream. The data is buffered, it reaches the file when the
+   * stream is flushed, seeked, read from or closed.
    * @param value value to write
    * @param size size of value
    */
   int write(const uint8_t *value, int size) override;
 
+  /**
+   * Writes the buffered data to the file.
+   * @return 0 on success, -1 if the buffered data could not be written
+   */
+  int flush() override;
+
   std::mutex file_lock_;
   std::unique_ptr<std::fstream> file_stream_;
   size_t offset_;
   std::string path_;
   size_t length_;
+  // whether there are written bytes that may not have reached the file yet
+  bool unflushed_writes_ = false;
 
   std::shared_ptr<logging::Logger> logger_;
+
+ private:
+  bool flushImpl();
 };
 
 }  // namespace io
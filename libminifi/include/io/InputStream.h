@@ -43,6 +43,18 @@ class InputStream : public virtual Stream {
    **/
   virtual int read(uint8_t *value, int len) = 0;
 
+  /**
+   * Provides the unread part of the stream without copying it, for streams holding
+   * their content in contiguous memory. The view is valid until the stream is closed,
+   * and obtaining it does not advance the stream.
+   * @param data set to the first unread byte
+   * @param len set to the number of unread bytes
+   * @return false if the stream cannot provide a view of its content
+   */
+  virtual bool getUnreadView(const uint8_t *&data, size_t &len) const {
+    return false;
+  }
+
   int read(std::vector<uint8_t>& buffer, int len);
 
   /**
@@ -0,0 +1,111 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_IO_MAPPEDFILESTREAM_H_
+#define LIBMINIFI_INCLUDE_IO_MAPPEDFILESTREAM_H_
+
+#include <memory>
+#include <string>
+#include "BaseStream.h"
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+/**
+ * Purpose: Read only stream over a file mapped into memory.
+ *
+ * Design: The whole file is mapped when the stream is created, so reads are plain copies out of
+ * the page cache and getUnreadView() exposes the content without any copy. The file must not be
+ * truncated while it is mapped, which holds for the immutable files of the content repository.
+ */
+class MappedFileStream : public io::BaseStream {
+ public:
+  /**
+   * Maps the file at path for reading.
+   * @param path path to file
+   * @param offset initial read position
+   */
+  explicit MappedFileStream(const std::string &path, uint64_t offset = 0);
+
+  MappedFileStream(const MappedFileStream&) = delete;
+  MappedFileStream& operator=(const MappedFileStream&) = delete;
+
+  ~MappedFileStream() override {
+    close();
+  }
+
+  /**
+   * Returns whether the file could be opened and mapped.
+   */
+  bool isOpen() const {
+    return open_;
+  }
+
+  void close() override;
+
+  /**
+   * Skip to the specified offset.
+   * @param offset offset from the beginning of the file
+   */
+  void seek(uint64_t offset) override;
+
+  size_t size() const override {
+    return length_;
+  }
+
+  /**
+   * Returns the beginning of the mapped file.
+   */
+  const uint8_t *getBuffer() const override {
+    return data_;
+  }
+
+  bool getUnreadView(const uint8_t *&data, size_t &len) const override;
+
+  using BaseStream::read;
+  using BaseStream::write;
+
+  int read(uint8_t *buf, int buflen) override;
+
+  /**
+   * The stream is read only, writing always fails.
+   */
+  int write(const uint8_t *value, int size) override {
+    return -1;
+  }
+
+ private:
+  std::string path_;
+  const uint8_t *data_ = nullptr;
+  size_t length_ = 0;
+  size_t offset_ = 0;
+  bool open_ = false;
+
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+}  // namespace io
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_IO_MAPPEDFILESTREAM_H_
@@ -47,6 +47,14 @@ class OutputStream : public virtual Stream {
    **/
   virtual int write(const uint8_t *value, int len) = 0;
 
+  /**
+   * Passes the data buffered by the stream on to its destination.
+   * @return 0 on success, -1 if the buffered data could not be written
+   */
+  virtual int flush() {
+    return 0;
+  }
+
   int write(const std::vector<uint8_t>& buffer, int len);
 
   /**
@@ -0,0 +1,110 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LIBMINIFI_INCLUDE_IO_SOCKETSELECTOR_H_
+#define LIBMINIFI_INCLUDE_IO_SOCKETSELECTOR_H_
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#ifdef WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif /* WIN32_LEAN_AND_MEAN */
+#include <WinSock2.h>
+#elif !defined(__linux__)
+#include <poll.h>
+#endif /* WIN32 */
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+/**
+ * Waits for a set of socket descriptors to become readable.
+ *
+ * Backed by epoll on Linux and by poll() on other POSIX systems, so that the cost of a wait depends on the number
+ * of ready descriptors rather than on the highest descriptor, and descriptors above FD_SETSIZE can be watched.
+ * Windows falls back to select(). Readiness is level-triggered: a descriptor which is not drained is reported again
+ * by the next wait. The descriptor set may be modified from another thread while a wait is in progress.
+ */
+class SocketSelector {
+ public:
+#ifdef WIN32
+  using Descriptor = SOCKET;
+#else
+  using Descriptor = int;
+#endif /* WIN32 */
+
+  SocketSelector() = default;
+  SocketSelector(SocketSelector &&other) noexcept;
+  SocketSelector& operator=(SocketSelector &&other) noexcept;
+  SocketSelector(const SocketSelector&) = delete;
+  SocketSelector& operator=(const SocketSelector&) = delete;
+  ~SocketSelector();
+
+  /**
+   * Starts watching the descriptor. Adding a watched descriptor again has no effect.
+   * @return false if the descriptor could not be watched, the reason is in the last socket error
+   */
+  bool add(Descriptor fd);
+
+  /**
+   * Stops watching the descriptor. Has to be called before the descriptor is closed.
+   */
+  void remove(Descriptor fd);
+
+  /**
+   * Stops watching every descriptor.
+   */
+  void clear();
+
+  size_t size() const;
+
+  /**
+   * Waits until at least one of the watched descriptors is readable, or has been hung up, or the timeout elapses.
+   * @param timeout maximum time to wait, a negative value waits indefinitely
+   * @return the ready descriptors, empty on timeout, interruption or error
+   */
+  std::vector<Descriptor> wait(std::chrono::milliseconds timeout);
+
+ private:
+  mutable std::mutex mutex_;
+#ifdef WIN32
+  fd_set descriptors_{};
+#elif defined(__linux__)
+  // created on the first add(), so that client sockets which never wait don't hold an extra descriptor, and only
+  // closed with the selector: a wait in progress keeps using it without the lock
+  int epoll_fd_ = -1;
+  std::vector<Descriptor> descriptors_;
+#else
+  std::vector<pollfd> descriptors_;
+#endif /* WIN32 */
+};
+
+}  // namespace io
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
+
+#endif  // LIBMINIFI_INCLUDE_IO_SOCKETSELECTOR_H_
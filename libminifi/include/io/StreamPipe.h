@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <utility>
 #include "BaseStream.h"
@@ -46,8 +48,23 @@ class OutputStreamCallback {
 namespace internal {
 
 inline int64_t pipe(const std::shared_ptr<io::InputStream>& src, const std::shared_ptr<io::OutputStream>& dst) {
-  uint8_t buffer[4096U];
   int64_t totalTransferred = 0;
+  const uint8_t* view;
+  size_t viewSize;
+  if (src->getUnreadView(view, viewSize)) {
+    // write the content straight from the source, without copying it to an intermediate buffer
+    while (viewSize > 0) {
+      int writeRet = dst->write(view, static_cast<int>((std::min<size_t>)(viewSize, (std::numeric_limits<int>::max)())));
+      if (writeRet < 0) {
+        return writeRet;
+      }
+      view += writeRet;
+      viewSize -= writeRet;
+      totalTransferred += writeRet;
+    }
+    return totalTransferred;
+  }
+  uint8_t buffer[4096U];
   while (true) {
     int readRet = src->read(buffer, sizeof(buffer));
     if (readRet < 0) {
@@ -73,10 +73,14 @@ class Configuration : public Properties {
   static constexpr const char *nifi_provenance_repository_max_storage_size = "nifi.provenance.repository.max.storage.size";
   static constexpr const char *nifi_provenance_repository_max_storage_time = "nifi.provenance.repository.max.storage.time";
   static constexpr const char *nifi_provenance_repository_directory_default = "nifi.provenance.repository.directory.default";
+  static constexpr const char *nifi_provenance_repository_async_write = "nifi.provenance.repository.async.write";
   static constexpr const char *nifi_flowfile_repository_max_storage_size = "nifi.flowfile.repository.max.storage.size";
   static constexpr const char *nifi_flowfile_repository_max_storage_time = "nifi.flowfile.repository.max.storage.time";
   static constexpr const char *nifi_flowfile_repository_directory_default = "nifi.flowfile.repository.directory.default";
+  static constexpr const char *nifi_flowfile_repository_group_commit = "nifi.flowfile.repository.group.commit";
+  static constexpr const char *nifi_flowfile_repository_recovery_threads = "nifi.flowfile.repository.recovery.threads";
   static constexpr const char *nifi_dbcontent_repository_directory_default = "nifi.database.content.repository.directory.default";
+  static constexpr const char *nifi_slab_content_repository_max_segment_size = "nifi.slab.content.repository.max.segment.size";
   static constexpr const char *nifi_remote_input_secure = "nifi.remote.input.secure";
   static constexpr const char *nifi_remote_input_http = "nifi.remote.input.http.enabled";
   static constexpr const char *nifi_security_need_ClientAuth = "nifi.security.need.ClientAuth";
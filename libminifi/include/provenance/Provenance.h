@@ -18,6 +18,7 @@
 #ifndef LIBMINIFI_INCLUDE_PROVENANCE_PROVENANCE_H_
 #define LIBMINIFI_INCLUDE_PROVENANCE_PROVENANCE_H_
 
+#include <algorithm>
 #include <memory>
 #include <atomic>
 #include <cstdint>
@@ -179,7 +180,10 @@ class ProvenanceEventRecord : public core::SerializableComponent {
   }
   // Get Attributes
   std::map<std::string, std::string> getAttributes() {
-    return _attributes;
+    if (!_attributes) {
+      return {};
+    }
+    return *_attributes;
   }
   // Get Size
   uint64_t getFileSize() {
@@ -334,7 +338,7 @@ class ProvenanceEventRecord : public core::SerializableComponent {
     _lineageStartDate = flow->getlineageStartDate();
     _lineageIdentifiers = flow->getlineageIdentifiers();
     flow_uuid_ = flow->getUUID();
-    _attributes = flow->getAttributes();
+    _attributes = flow->shareAttributes();
     _size = flow->getSize();
     _offset = flow->getOffset();
     if (flow->getConnection())
@@ -346,7 +350,7 @@ class ProvenanceEventRecord : public core::SerializableComponent {
   using SerializableComponent::Serialize;
 
   // Serialize the event to a stream
-  bool Serialize(org::apache::nifi::minifi::io::BufferStream& outStream);
+  bool Serialize(org::apache::nifi::minifi::io::OutputStream& outStream) override;
 
   // Serialize and Persistent to the repository
   bool Serialize(const std::shared_ptr<core::SerializableComponent> &repo);
@@ -409,8 +413,8 @@ class ProvenanceEventRecord : public core::SerializableComponent {
   uint64_t _offset;
   // Full path to the content
   std::string _contentFullPath;
-  // Attributes key/values pairs for the flow record
-  std::map<std::string, std::string> _attributes;
+  // Attributes key/values pairs for the flow record, shared with the flow file until it modifies them
+  std::shared_ptr<const core::FlowFile::AttributeMap> _attributes;
   // UUID string for all parents
   std::vector<utils::Identifier> _lineageIdentifiers;
   // transitUri
@@ -458,17 +462,18 @@ class ProvenanceReporter {
     clear();
   }
   // Get events
-  std::set<std::shared_ptr<ProvenanceEventRecord>> getEvents() {
+  const std::vector<std::shared_ptr<ProvenanceEventRecord>>& getEvents() const {
     return _events;
   }
   // Add event
   void add(const std::shared_ptr<ProvenanceEventRecord> &event) {
-    _events.insert(event);
+    _events.push_back(event);
   }
   // Remove event
   void remove(const std::shared_ptr<ProvenanceEventRecord> &event) {
-    if (_events.find(event) != _events.end()) {
-      _events.erase(event);
+    auto it = std::find(_events.begin(), _events.end(), event);
+    if (it != _events.end()) {
+      _events.erase(it);
     }
   }
   //
@@ -524,8 +529,8 @@ class ProvenanceReporter {
 
  private:
   std::shared_ptr<logging::Logger> logger_;
-  // Incoming connection Iterator
-  std::set<std::shared_ptr<ProvenanceEventRecord>> _events;
+  // events of the session, in the order they were reported
+  std::vector<std::shared_ptr<ProvenanceEventRecord>> _events;
   // provenance repository.
   std::shared_ptr<core::Repository> repo_;
 
@@ -33,10 +33,12 @@
 #include "io/BaseStream.h"
 #include "io/ClientSocket.h"
 #include "io/BufferStream.h"
+#include "io/BufferedStream.h"
 #include "io/EndianCheck.h"
 #include "properties/Configure.h"
 #include "utils/HTTPClient.h"
 #include "utils/TimeUtil.h"
+#include "utils/GeneralUtils.h"
 
 namespace org {
 namespace apache {
@@ -165,6 +167,7 @@ class SiteToSitePeer : public org::apache::nifi::minifi::io::BaseStream {
 
   explicit SiteToSitePeer(SiteToSitePeer &&ss)
       : stream_(ss.stream_.release()),
+        buffered_stream_(std::move(ss.buffered_stream_)),
         host_(std::move(ss.host_)),
         port_(std::move(ss.port_)),
         local_network_interface_(std::move(ss.local_network_interface_)),
@@ -281,23 +284,53 @@ class SiteToSitePeer : public org::apache::nifi::minifi::io::BaseStream {
   }
 
   void setStream(std::unique_ptr<org::apache::nifi::minifi::io::BaseStream> stream) {
+    const bool buffered = buffered_stream_ != nullptr;
+    buffered_stream_ = nullptr;
     stream_ = nullptr;
     if (stream)
       stream_ = std::move(stream);
+    setWriteBuffering(buffered);
   }
 
   org::apache::nifi::minifi::io::BaseStream *getStream() {
     return stream_.get();
   }
 
+  /**
+   * Enables or disables coalescing the writes to the stream, so that the protocol fields are not sent
+   * one by one. The buffered data is sent before reading a response, on close and on flush().
+   */
+  void setWriteBuffering(bool enabled) {
+    if (!enabled && buffered_stream_) {
+      buffered_stream_->flush();
+      buffered_stream_ = nullptr;
+    } else if (enabled && !buffered_stream_ && stream_) {
+      buffered_stream_ = utils::make_unique<org::apache::nifi::minifi::io::BufferedStream>(gsl::make_not_null(stream_.get()));
+    }
+  }
+
+  /**
+   * Sends the buffered writes to the peer.
+   * @return 0 on success, -1 on failure
+   */
+  int flush() override {
+    return buffered_stream_ ? buffered_stream_->flush() : 0;
+  }
+
   using BaseStream::write;
   using BaseStream::read;
 
   int write(const uint8_t* data, int len) override {
+    if (buffered_stream_) {
+      return buffered_stream_->write(data, len);
+    }
     return stream_->write(data, len);
   }
 
   int read(uint8_t* data, int len) override {
+    if (buffered_stream_) {
+      return buffered_stream_->read(data, len);
+    }
     return stream_->read(data, len);
   }
 
@@ -314,6 +347,7 @@ class SiteToSitePeer : public org::apache::nifi::minifi::io::BaseStream {
       return *this;
     }
     stream_ = std::move(other.stream_);
+    buffered_stream_ = std::move(other.buffered_stream_);
     host_ = std::move(other.host_);
     port_ = std::move(other.port_);
     local_network_interface_ = std::move(other.local_network_interface_);
@@ -330,6 +364,9 @@ class SiteToSitePeer : public org::apache::nifi::minifi::io::BaseStream {
  private:
   std::unique_ptr<org::apache::nifi::minifi::io::BaseStream> stream_;
 
+  // wraps stream_ when the writes are buffered
+  std::unique_ptr<org::apache::nifi::minifi::io::BufferedStream> buffered_stream_;
+
   std::string host_;
 
   uint16_t port_;
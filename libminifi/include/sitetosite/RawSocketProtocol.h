@@ -44,6 +44,7 @@
 #include "SiteToSite.h"
 #include "SiteToSiteClient.h"
 #include "utils/Id.h"
+#include "utils/gsl.h"
 
 namespace org {
 namespace apache {
@@ -73,7 +74,7 @@ class RawSiteToSiteClient : public sitetosite::SiteToSiteClient {
    */
   RawSiteToSiteClient(std::unique_ptr<SiteToSitePeer> peer) // NOLINT
       : logger_(logging::LoggerFactory<RawSiteToSiteClient>::getLogger()) {
-    peer_ = std::move(peer);
+    setPeer(std::move(peer));
     _batchSize = 0;
     _batchCount = 0;
     _batchDuration = 0;
@@ -95,6 +96,14 @@ class RawSiteToSiteClient : public sitetosite::SiteToSiteClient {
     tearDown();
   }
 
+  void setPeer(std::unique_ptr<SiteToSitePeer> peer) override {
+    peer_ = std::move(peer);
+    if (peer_) {
+      // the protocol writes every field separately, send them together
+      peer_->setWriteBuffering(true);
+    }
+  }
+
  public:
   // setBatchSize
   void setBatchSize(uint64_t size) {
@@ -103,6 +112,9 @@ class RawSiteToSiteClient : public sitetosite::SiteToSiteClient {
   // setBatchCount
   void setBatchCount(uint64_t count) {
     _batchCount = count;
+    if (count > 0) {
+      flow_file_batch_size_ = gsl::narrow<size_t>(count);
+    }
   }
   // setBatchDuration
   void setBatchDuration(uint64_t duration) {
@@ -63,6 +63,7 @@ class SiteToSiteClient : public core::Connectable {
       : core::Connectable("SitetoSiteClient"),
         peer_state_(IDLE),
         _batchSendNanos(5000000000),
+        flow_file_batch_size_(100),
         ssl_context_service_(nullptr),
         logger_(logging::LoggerFactory<SiteToSiteClient>::getLogger()) {
     _supportedVersion[0] = 5;
@@ -262,6 +263,9 @@ class SiteToSiteClient : public core::Connectable {
   // BATCH_SEND_NANOS
   uint64_t _batchSendNanos;
 
+  // number of FlowFiles taken from the session at once while sending, follows the configured batch count
+  size_t flow_file_batch_size_;
+
   /***
    * versioning
    */
@@ -20,6 +20,7 @@
 
 #include <tuple>
 #include <functional>
+#include <map>
 #include <vector>
 #include <utility>
 
@@ -223,6 +224,10 @@ class FlatMap{
     return const_iterator{data_.end()};
   }
 
+  operator std::map<K, V>() const {
+    return {begin(), end()};
+  }
+
   bool operator==(const FlatMap& other) const {
     if (size() != other.size()) {
       return false;
@@ -50,6 +50,14 @@ class AfterExecute {
    * @return milliseconds since epoch after which we are eligible to re-run this task.
    */
   virtual std::chrono::milliseconds wait_time() = 0;
+  /**
+   * Determines whether the task is idle until new work is signalled, in which case wait_time()
+   * is only an upper bound and the task may be woken up earlier.
+   * @return true if the task may be woken up before wait_time() elapses.
+   */
+  virtual bool isWaitingForWork() {
+    return false;
+  }
 };
 
 /**
@@ -108,11 +116,12 @@ class SingleRunMonitor : public utils::AfterExecute<bool>{
 
 
 struct TaskRescheduleInfo {
-  TaskRescheduleInfo(bool result, std::chrono::milliseconds wait_time)
-    : wait_time_(wait_time), finished_(result) {}
+  TaskRescheduleInfo(bool result, std::chrono::milliseconds wait_time, bool wait_for_work = false)
+    : wait_time_(wait_time), finished_(result), wait_for_work_(wait_for_work) {}
 
   std::chrono::milliseconds wait_time_;
   bool finished_;
+  bool wait_for_work_;
 
   static TaskRescheduleInfo Done() {
     return TaskRescheduleInfo(true, std::chrono::milliseconds(0));
@@ -126,11 +135,18 @@ struct TaskRescheduleInfo {
     return TaskRescheduleInfo(false, std::chrono::milliseconds(0));
   }
 
+  /**
+   * Parks the task until it is woken up by ThreadPool::notifyWork, or at most for the given interval.
+   */
+  static TaskRescheduleInfo WaitForWork(std::chrono::milliseconds max_interval) {
+    return TaskRescheduleInfo(false, max_interval, true);
+  }
+
 #if defined(WIN32)
 // https://developercommunity.visualstudio.com/content/problem/60897/c-shared-state-futuresstate-default-constructs-the.html
 // Because of this bug we need to have this object default constructible, which makes no sense otherwise. Hack.
  private:
-  TaskRescheduleInfo() : wait_time_(std::chrono::milliseconds(0)), finished_(true) {}
+  TaskRescheduleInfo() : wait_time_(std::chrono::milliseconds(0)), finished_(true), wait_for_work_(false) {}
   friend class std::_Associated_state<TaskRescheduleInfo>;
 #endif
 };
@@ -144,6 +160,7 @@ class ComplexMonitor : public utils::AfterExecute<TaskRescheduleInfo> {
       return true;
     }
     current_wait_.store(result.wait_time_);
+    waiting_for_work_.store(result.wait_for_work_);
     return false;
   }
   bool isCancelled(const TaskRescheduleInfo &result) override {
@@ -157,8 +174,13 @@ class ComplexMonitor : public utils::AfterExecute<TaskRescheduleInfo> {
     return current_wait_.load();
   }
 
+  bool isWaitingForWork() override {
+    return waiting_for_work_.load();
+  }
+
  private:
   std::atomic<std::chrono::milliseconds> current_wait_ {std::chrono::milliseconds(0)};
+  std::atomic<bool> waiting_for_work_ {false};
 };
 
 }  // namespace utils
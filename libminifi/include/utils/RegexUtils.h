@@ -20,6 +20,7 @@
 #define LIBMINIFI_INCLUDE_UTILS_REGEXUTILS_H_
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #if defined(__GNUC__) && (__GNUC__ < 4 || (__GNUC__ == 4 && __GNUC_MINOR__ < 9))
@@ -52,6 +53,15 @@ class Regex {
   const std::vector<std::string>& getResult() const;
   const std::string& getSuffix() const;
 
+  /**
+   * Searches the characters in [begin, end) for the first match. Unlike match(), this doesn't copy the input or
+   * modify the regex, so the same compiled regex can be searched by several threads at once.
+   * @param groups filled with the range of the whole match followed by the ranges of the capture groups,
+   * a group which didn't participate in the match is an empty range at end
+   * @return whether a match was found
+   */
+  bool search(const char *begin, const char *end, std::vector<std::pair<const char*, const char*>> &groups) const;
+
   static bool matchesFullInput(const std::string &regex, const std::string &input);
 
  private:
@@ -25,15 +25,18 @@
 #include <iostream>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
 #include <map>
 #include <vector>
 #include <queue>
+#include <set>
 #include <future>
 #include <thread>
 #include <functional>
 
 #include "BackTrace.h"
 #include "MinifiConcurrentQueue.h"
+#include "concurrentqueue.h"
 #include "Monitors.h"
 #include "core/expect.h"
 #include "controllers/ThreadManagementService.h"
@@ -47,6 +50,9 @@ namespace utils {
 
 using TaskId = std::string;
 
+template<typename T>
+struct TaskState;
+
 /**
  * Worker task
  * purpose: Provides a wrapper for the functor
@@ -58,6 +64,7 @@ class Worker {
   explicit Worker(const std::function<T()> &task, const TaskId &identifier, std::unique_ptr<AfterExecute<T>> run_determinant)
       : identifier_(identifier),
         next_exec_time_(std::chrono::steady_clock::now()),
+        waiting_for_work_(false),
         task(task),
         run_determinant_(std::move(run_determinant)) {
     promise = std::make_shared<std::promise<T>>();
@@ -66,6 +73,7 @@ class Worker {
   explicit Worker(const std::function<T()> &task, const TaskId &identifier)
       : identifier_(identifier),
         next_exec_time_(std::chrono::steady_clock::now()),
+        waiting_for_work_(false),
         task(task),
         run_determinant_(nullptr) {
     promise = std::make_shared<std::promise<T>>();
@@ -73,7 +81,8 @@ class Worker {
 
   explicit Worker(const TaskId& identifier = {})
       : identifier_(identifier),
-        next_exec_time_(std::chrono::steady_clock::now()) {
+        next_exec_time_(std::chrono::steady_clock::now()),
+        waiting_for_work_(false) {
   }
 
   virtual ~Worker() = default;
@@ -84,9 +93,11 @@ class Worker {
   Worker(Worker &&other) noexcept
       : identifier_(std::move(other.identifier_)),
         next_exec_time_(std::move(other.next_exec_time_)),
+        waiting_for_work_(other.waiting_for_work_),
         task(std::move(other.task)),
         run_determinant_(std::move(other.run_determinant_)),
-        promise(other.promise) {
+        promise(other.promise),
+        state_(std::move(other.state_)) {
   }
 
   /**
@@ -103,6 +114,7 @@ class Worker {
       return false;
     }
     next_exec_time_ = (std::max)(next_exec_time_ + run_determinant_->wait_time(), std::chrono::steady_clock::now());
+    waiting_for_work_ = run_determinant_->isWaitingForWork();
     return true;
   }
 
@@ -118,6 +130,38 @@ class Worker {
     return run_determinant_->wait_time();
   }
 
+  /**
+   * Returns true if the last run reported that it is idle until new work arrives,
+   * so the task may be executed before its next execution time.
+   */
+  bool isWaitingForWork() const {
+    return waiting_for_work_;
+  }
+
+  /**
+   * Sets the state shared by the tasks of the same identifier.
+   */
+  void setState(std::shared_ptr<TaskState<T>> state) {
+    state_ = std::move(state);
+  }
+
+  const std::shared_ptr<TaskState<T>>& getState() const {
+    return state_;
+  }
+
+  /**
+   * Returns true if the task was stopped and must not be run anymore.
+   */
+  bool isCancelled() const;
+
+  /**
+   * Makes the task eligible for execution right away.
+   */
+  void wakeUp() {
+    next_exec_time_ = std::chrono::steady_clock::now();
+    waiting_for_work_ = false;
+  }
+
   Worker<T>(const Worker<T>&) = delete;
   Worker<T>& operator= (const Worker<T>&) = delete;
 
@@ -132,26 +176,64 @@ class Worker {
  protected:
   TaskId identifier_;
   std::chrono::time_point<std::chrono::steady_clock> next_exec_time_;
+  bool waiting_for_work_;
   std::function<T()> task;
   std::unique_ptr<AfterExecute<T>> run_determinant_;
   std::shared_ptr<std::promise<T>> promise;
+  std::shared_ptr<TaskState<T>> state_;
 };
 
+/**
+ * State shared by the tasks scheduled under the same identifier. Work notifications
+ * only touch the state of the notified tasks, never the queues of the whole pool.
+ */
+template<typename T>
+struct TaskState {
+  // cleared when the tasks are stopped
+  std::atomic<bool> active{true};
+  // set when work arrives for the tasks, cleared whenever one of them starts running
+  std::atomic<bool> work_notified{false};
+  // size of parked_tasks, so that notifications can skip the lock while no task is parked
+  std::atomic<size_t> parked_count{0};
+  // guards parked_tasks and timeout_pending
+  std::mutex mutex;
+  // tasks idle until work arrives or their next execution time passes
+  std::vector<Worker<T>> parked_tasks;
+  // whether the pool holds a parked timeout for this state
+  bool timeout_pending = false;
+};
+
+template<typename T>
+bool Worker<T>::isCancelled() const {
+  return state_ && !state_->active.load();
+}
+
 template<typename T>
 class DelayedTaskComparator {
  public:
-  bool operator()(Worker<T> &a, Worker<T> &b) {
+  bool operator()(const Worker<T> &a, const Worker<T> &b) const {
     return a.getNextExecutionTime() > b.getNextExecutionTime();
   }
 };
 
+template<typename T>
+class ParkedTimeoutComparator {
+ public:
+  bool operator()(const std::pair<std::chrono::steady_clock::time_point, std::shared_ptr<TaskState<T>>> &a,
+                  const std::pair<std::chrono::steady_clock::time_point, std::shared_ptr<TaskState<T>>> &b) const {
+    return a.first > b.first;
+  }
+};
+
 template<typename T>
 Worker<T>& Worker<T>::operator =(Worker<T> && other) noexcept {
   task = std::move(other.task);
   promise = other.promise;
   next_exec_time_ = std::move(other.next_exec_time_);
+  waiting_for_work_ = other.waiting_for_work_;
   identifier_ = std::move(other.identifier_);
   run_determinant_ = std::move(other.run_determinant_);
+  state_ = std::move(other.state_);
   return *this;
 }
 
@@ -180,7 +262,10 @@ class WorkerThread {
  * Thread pool
  * Purpose: Provides a thread pool with basic functionality similar to
  * ThreadPoolExecutor
- * Design: Locked control over a manager thread that controls the worker threads
+ * Design: Locked control over a manager thread that controls the worker threads.
+ * Ready tasks are kept in a lock-free queue: every worker re-enqueues its tasks into its
+ * own sub-queue and dequeues round-robin from all of them, so busy workers share their
+ * backlog with idle ones. Worker threads only block when there is nothing to run.
  */
 template<typename T>
 class ThreadPool {
@@ -196,6 +281,7 @@ class ThreadPool {
         name_(name) {
     current_workers_ = 0;
     task_count_ = 0;
+    idle_workers_ = 0;
     thread_manager_ = nullptr;
   }
 
@@ -225,15 +311,28 @@ class ThreadPool {
    */
   void stopTasks(const TaskId &identifier);
 
+  /**
+   * Wakes up the tasks with the provided identifier that are idle waiting for work,
+   * moving them straight to the worker queue. If none of them is idle at the moment,
+   * the next one going idle without having run since is rescheduled immediately instead.
+   * @param identifier for worker tasks.
+   */
+  void notifyWork(const TaskId &identifier);
+
+  /**
+   * Returns a function doing notifyWork for the tasks currently scheduled with the provided
+   * identifier, without looking them up on every call. Empty if no such task was executed.
+   * @param identifier for worker tasks.
+   */
+  std::function<void()> getWorkNotifier(const TaskId &identifier);
+
   /**
    * Returns true if a task is running.
    */
   bool isTaskRunning(const TaskId &identifier) const {
-    try {
-      return task_status_.at(identifier) == true;
-    } catch (const std::out_of_range &) {
-      return false;
-    }
+    std::lock_guard<std::mutex> lock(worker_queue_mutex_);
+    const auto status = task_status_.find(identifier);
+    return status != task_status_.end() && status->second->active.load();
   }
 
   bool isRunning() const {
@@ -303,11 +402,14 @@ class ThreadPool {
    * Drain will notify tasks to stop following notification
    */
   void drain() {
-    worker_queue_.stop();
+    {
+      std::lock_guard<std::mutex> lock(idle_mutex_);
+      worker_available_.notify_all();
+    }
     while (current_workers_ > 0) {
       // The sleeping workers were waken up and stopped, but we have to wait
-      // the ones that actually worked on something when the queue was stopped.
-      // Stopping the queue guarantees that they don't get any new task.
+      // the ones that actually worked on something when the pool was stopped.
+      // As running_ is cleared they don't take any new task.
       std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
   }
@@ -336,14 +438,23 @@ class ThreadPool {
   // thread queue for the recently deceased threads.
   ConcurrentQueue<std::shared_ptr<WorkerThread>> deceased_thread_queue_;
 // worker queue of worker objects
-  ConditionConcurrentQueue<Worker<T>> worker_queue_;
-  std::priority_queue<Worker<T>, std::vector<Worker<T>>, DelayedTaskComparator<T>> delayed_worker_queue_;
-// mutex to  protect task status and delayed queue
-  std::mutex worker_queue_mutex_;
+  moodycamel::ConcurrentQueue<Worker<T>> worker_queue_;
+// number of worker threads blocked waiting for a task
+  std::atomic<int> idle_workers_;
+// mutex and condition used by the idle worker threads to wait for a task
+  std::mutex idle_mutex_;
+  std::condition_variable worker_available_;
+// heap of delayed worker objects ordered by DelayedTaskComparator
+  std::vector<Worker<T>> delayed_worker_queue_;
+// heap of the times the parked tasks of a state have to be woken up at the latest, earliest first;
+// holds at most one entry per state
+  std::vector<std::pair<std::chrono::steady_clock::time_point, std::shared_ptr<TaskState<T>>>> parked_timeouts_;
+// mutex to  protect task status, delayed queue and parked timeouts
+  mutable std::mutex worker_queue_mutex_;
 // notification for new delayed tasks that's before the current ones
   std::condition_variable delayed_task_available_;
-// map to identify if a task should be
-  std::map<TaskId, bool> task_status_;
+// map to identify if a task should be; the states are shared with the worker objects
+  std::map<TaskId, std::shared_ptr<TaskState<T>>> task_status_;
 // manager mutex
   std::recursive_mutex manager_mutex_;
   // thread pool name
@@ -360,6 +471,44 @@ class ThreadPool {
   void run_tasks(std::shared_ptr<WorkerThread> thread);
 
   void manage_delayed_queue();
+
+  /**
+   * Puts a task that has to wait until its next execution time to the delayed queue.
+   * Requires worker_queue_mutex_ to be held.
+   */
+  void delay(Worker<T> &&task);
+
+  /**
+   * Parks a task that is idle until work arrives for it, unless work arrived since it started running.
+   */
+  void park(moodycamel::ProducerToken &producer, Worker<T> &&task);
+
+  /**
+   * Moves the parked tasks of the state to the worker queue, all of them or only the ones whose next
+   * execution time has passed.
+   */
+  void wakeUpParkedTasks(const std::shared_ptr<TaskState<T>> &state, bool only_due);
+
+  void notifyWork(const std::shared_ptr<TaskState<T>> &state);
+
+  /**
+   * Requires worker_queue_mutex_ to be held.
+   */
+  void addParkedTimeout(std::chrono::steady_clock::time_point time, std::shared_ptr<TaskState<T>> state);
+
+  /**
+   * Puts a task to the worker queue, waking up an idle worker thread if there is one.
+   */
+  void enqueue(Worker<T> &&task);
+  void enqueue(moodycamel::ProducerToken &producer, Worker<T> &&task);
+
+  /**
+   * Takes the next task from the worker queue, blocking while it is empty.
+   * @return false if the thread pool was stopped
+   */
+  bool dequeue(moodycamel::ConsumerToken &consumer, Worker<T> &task);
+
+  void notifyIdleWorker();
 };
 
 }  // namespace utils
@@ -45,10 +45,14 @@ constexpr const char *Configuration::nifi_server_report_interval;
 constexpr const char *Configuration::nifi_provenance_repository_max_storage_size;
 constexpr const char *Configuration::nifi_provenance_repository_max_storage_time;
 constexpr const char *Configuration::nifi_provenance_repository_directory_default;
+constexpr const char *Configuration::nifi_provenance_repository_async_write;
 constexpr const char *Configuration::nifi_flowfile_repository_max_storage_size;
 constexpr const char *Configuration::nifi_flowfile_repository_max_storage_time;
 constexpr const char *Configuration::nifi_flowfile_repository_directory_default;
+constexpr const char *Configuration::nifi_flowfile_repository_group_commit;
+constexpr const char *Configuration::nifi_flowfile_repository_recovery_threads;
 constexpr const char *Configuration::nifi_dbcontent_repository_directory_default;
+constexpr const char *Configuration::nifi_slab_content_repository_max_segment_size;
 constexpr const char *Configuration::nifi_remote_input_secure;
 constexpr const char *Configuration::nifi_remote_input_http;
 constexpr const char *Configuration::nifi_security_need_ClientAuth;
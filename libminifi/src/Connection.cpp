@@ -48,7 +48,11 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   max_queue_size_ = 0;
   max_data_queue_size_ = 0;
   expired_duration_ = 0;
+  queued_count_ = 0;
   queued_data_size_ = 0;
+  penalized_count_ = 0;
+  next_penalty_expiration_ = 0;
+  next_sequence_ = 0;
   drop_empty_ = false;
 
   logger_->log_debug("Connection %s created", name_);
@@ -64,7 +68,11 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   max_queue_size_ = 0;
   max_data_queue_size_ = 0;
   expired_duration_ = 0;
+  queued_count_ = 0;
   queued_data_size_ = 0;
+  penalized_count_ = 0;
+  next_penalty_expiration_ = 0;
+  next_sequence_ = 0;
   drop_empty_ = false;
 
   logger_->log_debug("Connection %s created", name_);
@@ -84,7 +92,11 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   max_queue_size_ = 0;
   max_data_queue_size_ = 0;
   expired_duration_ = 0;
+  queued_count_ = 0;
   queued_data_size_ = 0;
+  penalized_count_ = 0;
+  next_penalty_expiration_ = 0;
+  next_sequence_ = 0;
   drop_empty_ = false;
 
   logger_->log_debug("Connection %s created", name_);
@@ -105,26 +117,26 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   max_queue_size_ = 0;
   max_data_queue_size_ = 0;
   expired_duration_ = 0;
+  queued_count_ = 0;
   queued_data_size_ = 0;
+  penalized_count_ = 0;
+  next_penalty_expiration_ = 0;
+  next_sequence_ = 0;
   drop_empty_ = false;
 
   logger_->log_debug("Connection %s created", name_);
 }
 
 bool Connection::isEmpty() {
-  std::lock_guard<std::mutex> lock(mutex_);
-
-  return queue_.empty();
+  return queued_count_ == 0;
 }
 
 bool Connection::isFull() {
-  std::lock_guard<std::mutex> lock(mutex_);
-
   if (max_queue_size_ <= 0 && max_data_queue_size_ <= 0)
     // No back pressure setting
     return false;
 
-  if (max_queue_size_ > 0 && queue_.size() >= max_queue_size_)
+  if (max_queue_size_ > 0 && queued_count_ >= max_queue_size_)
     return true;
 
   if (max_data_queue_size_ > 0 && queued_data_size_ >= max_data_queue_size_)
@@ -133,20 +145,100 @@ bool Connection::isFull() {
   return false;
 }
 
+bool Connection::isWorkAvailable() {
+  if (queued_count_ > penalized_count_)
+    return true;
+  return penalized_count_ > 0 && next_penalty_expiration_ <= utils::timeutils::getTimeMillis();
+}
+
+void Connection::push(const std::shared_ptr<core::FlowFile>& flow) {
+  if (!prioritizer_) {
+    queue_.enqueue(flow);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(priority_mutex_);
+  prioritized_.push_back(PrioritizedFlowFile{flow, next_sequence_++});
+  std::push_heap(prioritized_.begin(), prioritized_.end(), [this](const PrioritizedFlowFile& lhs, const PrioritizedFlowFile& rhs) {
+    return isHandedOutLater(lhs, rhs);
+  });
+}
+
+bool Connection::pop(std::shared_ptr<core::FlowFile>& flow) {
+  if (!prioritizer_) {
+    return queue_.try_dequeue(flow);
+  }
+  std::lock_guard<std::mutex> lock(priority_mutex_);
+  return popPrioritized(flow);
+}
+
+bool Connection::popPrioritized(std::shared_ptr<core::FlowFile>& flow) {
+  if (prioritized_.empty()) {
+    return false;
+  }
+  std::pop_heap(prioritized_.begin(), prioritized_.end(), [this](const PrioritizedFlowFile& lhs, const PrioritizedFlowFile& rhs) {
+    return isHandedOutLater(lhs, rhs);
+  });
+  flow = std::move(prioritized_.back().flow);
+  prioritized_.pop_back();
+  return true;
+}
+
+bool Connection::isHandedOutLater(const PrioritizedFlowFile& lhs, const PrioritizedFlowFile& rhs) const {
+  const int comparison = prioritizer_->compare(*lhs.flow, *rhs.flow);
+  if (comparison != 0) {
+    return comparison > 0;
+  }
+  return lhs.sequence > rhs.sequence;
+}
+
+void Connection::enqueue(const std::shared_ptr<core::FlowFile>& flow) {
+  // counters are raised before the item becomes visible to consumers so that they never underflow
+  ++queued_count_;
+  queued_data_size_ += flow->getSize();
+  push(flow);
+}
+
+bool Connection::dequeue(std::shared_ptr<core::FlowFile>& flow) {
+  if (!pop(flow)) {
+    return false;
+  }
+  --queued_count_;
+  queued_data_size_ -= flow->getSize();
+  return true;
+}
+
+void Connection::penalize(const std::shared_ptr<core::FlowFile>& flow) {
+  // the flow file is still queued, it just cannot be handed out until its penalty expires
+  ++queued_count_;
+  queued_data_size_ += flow->getSize();
+  std::lock_guard<std::mutex> lock(penalty_mutex_);
+  penalized_.push(flow);
+  ++penalized_count_;
+  next_penalty_expiration_ = penalized_.top()->getPenaltyExpiration();
+}
+
+void Connection::releaseExpiredPenalties(uint64_t now) {
+  if (penalized_count_ == 0 || next_penalty_expiration_ > now)
+    return;
+  std::lock_guard<std::mutex> lock(penalty_mutex_);
+  while (!penalized_.empty() && penalized_.top()->getPenaltyExpiration() <= now) {
+    push(penalized_.top());
+    penalized_.pop();
+    --penalized_count_;
+  }
+  if (!penalized_.empty())
+    next_penalty_expiration_ = penalized_.top()->getPenaltyExpiration();
+}
+
 void Connection::put(const std::shared_ptr<core::FlowFile>& flow) {
   if (drop_empty_ && flow->getSize() == 0) {
     logger_->log_info("Dropping empty flow file: %s", flow->getUUIDStr());
     return;
   }
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
 
-    queue_.push(flow);
+  enqueue(flow);
 
-    queued_data_size_ += flow->getSize();
-
-    logger_->log_debug("Enqueue flow file UUID %s to connection %s", flow->getUUIDStr(), name_);
-  }
+  logger_->log_debug("Enqueue flow file UUID %s to connection %s", flow->getUUIDStr(), name_);
 
   // Notify receiving processor that work may be available
   if (dest_connectable_) {
@@ -156,20 +248,15 @@ void Connection::put(const std::shared_ptr<core::FlowFile>& flow) {
 }
 
 void Connection::multiPut(std::vector<std::shared_ptr<core::FlowFile>>& flows) {
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    for (auto &ff : flows) {
-      if (drop_empty_ && ff->getSize() == 0) {
-        logger_->log_info("Dropping empty flow file: %s", ff->getUUIDStr());
-        continue;
-      }
+  for (auto &ff : flows) {
+    if (drop_empty_ && ff->getSize() == 0) {
+      logger_->log_info("Dropping empty flow file: %s", ff->getUUIDStr());
+      continue;
+    }
 
-      queue_.push(ff);
-      queued_data_size_ += ff->getSize();
+    enqueue(ff);
 
-      logger_->log_debug("Enqueue flow file UUID %s to connection %s", ff->getUUIDStr(), name_);
-    }
+    logger_->log_debug("Enqueue flow file UUID %s to connection %s", ff->getUUIDStr(), name_);
   }
 
   if (dest_connectable_) {
@@ -179,66 +266,105 @@ void Connection::multiPut(std::vector<std::shared_ptr<core::FlowFile>>& flows) {
 }
 
 std::shared_ptr<core::FlowFile> Connection::poll(std::set<std::shared_ptr<core::FlowFile>> &expiredFlowRecords) {
-  std::lock_guard<std::mutex> lock(mutex_);
-
-  while (!queue_.empty()) {
-    std::shared_ptr<core::FlowFile> item = queue_.front();
-    queue_.pop();
-    queued_data_size_ -= item->getSize();
+  const uint64_t now = utils::timeutils::getTimeMillis();
+  releaseExpiredPenalties(now);
 
+  std::shared_ptr<core::FlowFile> item;
+  while (dequeue(item)) {
     if (expired_duration_ > 0) {
       // We need to check for flow expiration
-      if (utils::timeutils::getTimeMillis() > (item->getEntryDate() + expired_duration_)) {
+      if (now > (item->getEntryDate() + expired_duration_)) {
         // Flow record expired
         expiredFlowRecords.insert(item);
         logger_->log_debug("Delete flow file UUID %s from connection %s, because it expired", item->getUUIDStr(), name_);
-      } else {
-        // Flow record not expired
-        if (item->isPenalized()) {
-          // Flow record was penalized
-          queue_.push(item);
-          queued_data_size_ += item->getSize();
-          break;
-        }
-        std::shared_ptr<Connectable> connectable = std::static_pointer_cast<Connectable>(shared_from_this());
-        item->setConnection(connectable);
-        logger_->log_debug("Dequeue flow file UUID %s from connection %s", item->getUUIDStr(), name_);
-        return item;
-      }
-    } else {
-      // Flow record not expired
-      if (item->isPenalized()) {
-        // Flow record was penalized
-        queue_.push(item);
-        queued_data_size_ += item->getSize();
-        break;
+        continue;
       }
-      std::shared_ptr<Connectable> connectable = std::static_pointer_cast<Connectable>(shared_from_this());
-      item->setConnection(connectable);
-      logger_->log_debug("Dequeue flow file UUID %s from connection %s", item->getUUIDStr(), name_);
-      return item;
     }
+    if (item->getPenaltyExpiration() > now) {
+      // Flow record was penalized, park it so that it does not block the ones behind it
+      penalize(item);
+      continue;
+    }
+    std::shared_ptr<Connectable> connectable = std::static_pointer_cast<Connectable>(shared_from_this());
+    item->setConnection(connectable);
+    logger_->log_debug("Dequeue flow file UUID %s from connection %s", item->getUUIDStr(), name_);
+    return item;
   }
 
   return NULL;
 }
 
+std::vector<std::shared_ptr<core::FlowFile>> Connection::pollBatch(size_t max_count, uint64_t max_bytes, std::set<std::shared_ptr<core::FlowFile>> &expiredFlowRecords) {
+  std::vector<std::shared_ptr<core::FlowFile>> items;
+  if (max_count == 0) {
+    return items;
+  }
+  const uint64_t now = utils::timeutils::getTimeMillis();
+  releaseExpiredPenalties(now);
+
+  std::vector<std::shared_ptr<core::FlowFile>> penalized;
+  uint64_t batch_size = 0;
+  {
+    // the priority heap is locked once for the whole batch, the lock-free queue needs no lock at all
+    std::unique_lock<std::mutex> lock(priority_mutex_, std::defer_lock);
+    if (prioritizer_) {
+      lock.lock();
+    }
+    std::shared_ptr<core::FlowFile> item;
+    while (items.size() < max_count && (max_bytes == 0 || batch_size < max_bytes) && (prioritizer_ ? popPrioritized(item) : queue_.try_dequeue(item))) {
+      --queued_count_;
+      queued_data_size_ -= item->getSize();
+      if (expired_duration_ > 0 && now > (item->getEntryDate() + expired_duration_)) {
+        logger_->log_debug("Delete flow file UUID %s from connection %s, because it expired", item->getUUIDStr(), name_);
+        expiredFlowRecords.insert(std::move(item));
+        continue;
+      }
+      if (item->getPenaltyExpiration() > now) {
+        penalized.push_back(std::move(item));
+        continue;
+      }
+      batch_size += item->getSize();
+      items.push_back(std::move(item));
+    }
+  }
+
+  // penalize() takes the penalty lock which must not be acquired while holding the priority lock
+  for (const auto& flow : penalized) {
+    penalize(flow);
+  }
+
+  if (!items.empty()) {
+    std::shared_ptr<Connectable> connectable = std::static_pointer_cast<Connectable>(shared_from_this());
+    for (const auto& item : items) {
+      item->setConnection(connectable);
+    }
+    logger_->log_debug("Dequeue %zu flow files from connection %s", items.size(), name_);
+  }
+  return items;
+}
+
 void Connection::drain(bool delete_permanently) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  {
+    // penalties do not matter here, hand the parked flow files back to the queue so that they are drained too
+    std::lock_guard<std::mutex> lock(penalty_mutex_);
+    while (!penalized_.empty()) {
+      push(penalized_.top());
+      penalized_.pop();
+      --penalized_count_;
+    }
+  }
 
-  while (!queue_.empty()) {
-    std::shared_ptr<core::FlowFile> item = queue_.front();
-    queue_.pop();
+  std::shared_ptr<core::FlowFile> item;
+  while (dequeue(item)) {
     logger_->log_debug("Delete flow file UUID %s from connection %s, because it expired", item->getUUIDStr(), name_);
     if (delete_permanently) {
-      if (item->isStored() && flow_repository_->Delete(item->getUUIDStr())) {
+      if (item->isStored() && flow_repository_->Delete(item->getUUIDStr(), item->getResourceClaim())) {
         item->setStoredToRepository(false);
         auto claim = item->getResourceClaim();
         if (claim) claim->decreaseFlowFileRecordOwnedCount();
       }
     }
   }
-  queued_data_size_ = 0;
   logger_->log_debug("Drain connection %s", name_);
 }
 
@@ -34,6 +34,13 @@ void EventDrivenSchedulingAgent::schedule(std::shared_ptr<core::Processor> proce
     throw Exception(PROCESS_SCHEDULE_EXCEPTION, "EventDrivenSchedulingAgent cannot schedule processor without incoming connection!");
   }
   ThreadedSchedulingAgent::schedule(processor);
+  // incoming flow files wake up the idle tasks of the processor directly
+  processor->setWorkNotifier(thread_pool_.getWorkNotifier(processor->getUUIDStr()));
+}
+
+void EventDrivenSchedulingAgent::unschedule(std::shared_ptr<core::Processor> processor) {
+  processor->setWorkNotifier(nullptr);
+  ThreadedSchedulingAgent::unschedule(processor);
 }
 
 utils::TaskRescheduleInfo EventDrivenSchedulingAgent::run(const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<core::ProcessContext> &processContext,
@@ -47,9 +54,14 @@ utils::TaskRescheduleInfo EventDrivenSchedulingAgent::run(const std::shared_ptr<
         // Honor the yield
         return utils::TaskRescheduleInfo::RetryIn(std::chrono::milliseconds(processor->getYieldTime()));
       } else if (shouldYield) {
-        // No work to do or need to apply back pressure
-        return utils::TaskRescheduleInfo::RetryIn(
-            std::chrono::milliseconds((this->bored_yield_duration_ > 0) ? this->bored_yield_duration_ : 10));  // No work left to do, stand by
+        if (processor->isThrottledByBackpressure()) {
+          // Draining the outgoing connections does not notify us, so poll again shortly
+          return utils::TaskRescheduleInfo::RetryIn(
+              std::chrono::milliseconds((this->bored_yield_duration_ > 0) ? this->bored_yield_duration_ : 10));
+        }
+        // No work left to do, stand by until a flow file arrives (or penalized ones may have expired)
+        return utils::TaskRescheduleInfo::WaitForWork(
+            std::chrono::milliseconds((this->bored_yield_duration_ > 0) ? this->bored_yield_duration_ : DEFAULT_MAX_WAIT_FOR_WORK_MS));
       }
     }
     return utils::TaskRescheduleInfo::RetryImmediately();  // Let's continue work as soon as a thread is available
@@ -18,7 +18,10 @@
  * limitations under the License.
  */
 #include <time.h>
+#include <algorithm>
 #include <cstdio>
+#include <iterator>
+#include <limits>
 #include <vector>
 #include <queue>
 #include <map>
@@ -37,6 +40,95 @@ namespace apache {
 namespace nifi {
 namespace minifi {
 
+namespace {
+
+// records of the original format start with the most significant byte of the event time, which is 0
+constexpr uint8_t FORMAT_MARKER = 0xFF;
+constexpr uint8_t FORMAT_VERSION = 2;
+
+enum ClaimEncoding : uint8_t {
+  FULL_PATH = 0,
+  RELATIVE_PATH = 1
+};
+
+// the position of a key is persisted, new keys may only be appended along with a new format version
+const std::vector<std::string>& getInternedAttributeKeys() {
+  static const std::vector<std::string> keys{
+    core::SpecialFlowAttribute::PATH,
+    core::SpecialFlowAttribute::ABSOLUTE_PATH,
+    core::SpecialFlowAttribute::FILENAME,
+    core::SpecialFlowAttribute::UUID,
+    core::SpecialFlowAttribute::priority,
+    core::SpecialFlowAttribute::MIME_TYPE,
+    core::SpecialFlowAttribute::DISCARD_REASON,
+    core::SpecialFlowAttribute::ALTERNATE_IDENTIFIER,
+    core::SpecialFlowAttribute::FLOW_ID,
+    "fragment.identifier",
+    "fragment.index",
+    "fragment.count",
+    "segment.original.filename"
+  };
+  return keys;
+}
+
+bool writeVarint(io::OutputStream &stream, uint64_t value) {
+  uint8_t buffer[10];
+  int length = 0;
+  while (value >= 0x80) {
+    buffer[length++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  buffer[length++] = static_cast<uint8_t>(value);
+  return stream.write(buffer, length) == length;
+}
+
+bool readVarint(io::InputStream &stream, uint64_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t byte;
+    if (stream.read(&byte, 1) != 1) {
+      return false;
+    }
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool writeString(io::OutputStream &stream, const std::string &str) {
+  if (!writeVarint(stream, str.size())) {
+    return false;
+  }
+  return str.empty() || stream.write(reinterpret_cast<const uint8_t*>(str.data()), gsl::narrow<int>(str.size())) == gsl::narrow<int>(str.size());
+}
+
+bool readString(io::InputStream &stream, std::string &str) {
+  uint64_t length;
+  if (!readVarint(stream, length) || length > static_cast<uint64_t>((std::numeric_limits<int>::max)())) {
+    return false;
+  }
+  str.resize(length);
+  return length == 0 || stream.read(reinterpret_cast<uint8_t*>(&str[0]), static_cast<int>(length)) == static_cast<int>(length);
+}
+
+bool writeIdentifier(io::OutputStream &stream, const utils::Identifier &id) {
+  const auto &data = id.toArray();
+  return stream.write(data.data(), data.size()) == static_cast<int>(data.size());
+}
+
+bool readIdentifier(io::InputStream &stream, utils::Identifier &id) {
+  utils::Identifier::Data data;
+  if (stream.read(data.data(), data.size()) != static_cast<int>(data.size())) {
+    return false;
+  }
+  id = data;
+  return true;
+}
+
+}  // namespace
+
 std::shared_ptr<logging::Logger> FlowFileRecord::logger_ = logging::LoggerFactory<FlowFileRecord>::getLogger();
 std::atomic<uint64_t> FlowFileRecord::local_flow_seq_number_(0);
 
@@ -69,25 +161,16 @@ std::shared_ptr<FlowFileRecord> FlowFileRecord::DeSerialize(const std::string& k
 }
 
 bool FlowFileRecord::Serialize(io::OutputStream &outStream) {
-  int ret;
-
-  ret = outStream.write(event_time_);
-  if (ret != 8) {
+  const uint8_t header[] = {FORMAT_MARKER, FORMAT_VERSION};
+  if (outStream.write(header, sizeof(header)) != sizeof(header)) {
     return false;
   }
 
-  ret = outStream.write(entry_date_);
-  if (ret != 8) {
+  if (!writeVarint(outStream, event_time_) || !writeVarint(outStream, entry_date_) || !writeVarint(outStream, lineage_start_date_)) {
     return false;
   }
 
-  ret = outStream.write(lineage_start_date_);
-  if (ret != 8) {
-    return false;
-  }
-
-  ret = outStream.write(uuid_);
-  if (ret <= 0) {
+  if (!writeIdentifier(outStream, uuid_)) {
     return false;
   }
 
@@ -95,40 +178,36 @@ bool FlowFileRecord::Serialize(io::OutputStream &outStream) {
   if (connection_) {
     containerId = connection_->getUUID();
   }
-  ret = outStream.write(containerId);
-  if (ret <= 0) {
+  if (!writeIdentifier(outStream, containerId)) {
     return false;
   }
-  // write flow attributes
-  uint32_t numAttributes = attributes_.size();
-  ret = outStream.write(numAttributes);
-  if (ret != 4) {
+
+  // write flow attributes, keys of the dictionary as their index + 1, any other key inline after a 0
+  if (!writeVarint(outStream, attributes_->size())) {
     return false;
   }
-
-  for (auto& itAttribute : attributes_) {
-    ret = outStream.write(itAttribute.first, true);
-    if (ret <= 0) {
+  const auto& keys = getInternedAttributeKeys();
+  for (auto& itAttribute : *attributes_) {
+    auto key = std::find(keys.begin(), keys.end(), itAttribute.first);
+    if (key != keys.end()) {
+      if (!writeVarint(outStream, std::distance(keys.begin(), key) + 1)) {
+        return false;
+      }
+    } else if (!writeVarint(outStream, 0) || !writeString(outStream, itAttribute.first)) {
       return false;
     }
-    ret = outStream.write(itAttribute.second, true);
-    if (ret <= 0) {
+    if (!writeString(outStream, itAttribute.second)) {
       return false;
     }
   }
 
-  ret = outStream.write(getContentFullPath());
-  if (ret <= 0) {
+  const std::string relative_path = claim_ ? claim_->getRelativePath() : "";
+  const uint8_t claim_encoding = relative_path.empty() ? FULL_PATH : RELATIVE_PATH;
+  if (outStream.write(&claim_encoding, 1) != 1 || !writeString(outStream, relative_path.empty() ? getContentFullPath() : relative_path)) {
     return false;
   }
 
-  ret = outStream.write(size_);
-  if (ret != 8) {
-    return false;
-  }
-
-  ret = outStream.write(offset_);
-  if (ret != 8) {
+  if (!writeVarint(outStream, size_) || !writeVarint(outStream, offset_)) {
     return false;
   }
 
@@ -160,14 +239,31 @@ bool FlowFileRecord::Persist(const std::shared_ptr<core::Repository>& flowReposi
 }
 
 std::shared_ptr<FlowFileRecord> FlowFileRecord::DeSerialize(io::InputStream& inStream, const std::shared_ptr<core::ContentRepository>& content_repo, utils::Identifier& container) {
+  uint8_t marker;
+  if (inStream.read(&marker, 1) != 1) {
+    return {};
+  }
+  if (marker == FORMAT_MARKER) {
+    return DeSerializeV2(inStream, content_repo, container);
+  }
+  return DeSerializeV1(marker, inStream, content_repo, container);
+}
+
+std::shared_ptr<FlowFileRecord> FlowFileRecord::DeSerializeV1(uint8_t first_byte, io::InputStream& inStream, const std::shared_ptr<core::ContentRepository>& content_repo, utils::Identifier& container) {
   int ret;
 
   auto file = std::make_shared<FlowFileRecord>();
 
-  ret = inStream.read(file->event_time_);
-  if (ret != 8) {
+  // the first byte of the event time has already been read
+  uint8_t event_time[7];
+  ret = inStream.read(event_time, sizeof(event_time));
+  if (ret != sizeof(event_time)) {
     return {};
   }
+  file->event_time_ = first_byte;
+  for (uint8_t byte : event_time) {
+    file->event_time_ = (file->event_time_ << 8) | byte;
+  }
 
   ret = inStream.read(file->entry_date_);
   if (ret != 8) {
@@ -207,7 +303,7 @@ std::shared_ptr<FlowFileRecord> FlowFileRecord::DeSerialize(io::InputStream& inS
     if (ret <= 0) {
       return {};
     }
-    file->attributes_[key] = value;
+    file->mutableAttributes()[key] = value;
   }
 
   std::string content_full_path;
@@ -231,6 +327,65 @@ std::shared_ptr<FlowFileRecord> FlowFileRecord::DeSerialize(io::InputStream& inS
   return file;
 }
 
+std::shared_ptr<FlowFileRecord> FlowFileRecord::DeSerializeV2(io::InputStream& inStream, const std::shared_ptr<core::ContentRepository>& content_repo, utils::Identifier& container) {
+  uint8_t version;
+  if (inStream.read(&version, 1) != 1 || version != FORMAT_VERSION) {
+    return {};
+  }
+
+  auto file = std::make_shared<FlowFileRecord>();
+
+  if (!readVarint(inStream, file->event_time_) || !readVarint(inStream, file->entry_date_) || !readVarint(inStream, file->lineage_start_date_)) {
+    return {};
+  }
+
+  if (!readIdentifier(inStream, file->uuid_) || !readIdentifier(inStream, container)) {
+    return {};
+  }
+
+  // read flow attributes
+  uint64_t numAttributes;
+  if (!readVarint(inStream, numAttributes)) {
+    return {};
+  }
+
+  const auto& keys = getInternedAttributeKeys();
+  for (uint64_t i = 0; i < numAttributes; i++) {
+    uint64_t keyIndex;
+    if (!readVarint(inStream, keyIndex) || keyIndex > keys.size()) {
+      return {};
+    }
+    std::string key;
+    if (keyIndex > 0) {
+      key = keys[keyIndex - 1];
+    } else if (!readString(inStream, key)) {
+      return {};
+    }
+    std::string value;
+    if (!readString(inStream, value)) {
+      return {};
+    }
+    file->mutableAttributes()[key] = value;
+  }
+
+  uint8_t claim_encoding;
+  std::string content_path;
+  if (inStream.read(&claim_encoding, 1) != 1 || claim_encoding > RELATIVE_PATH || !readString(inStream, content_path)) {
+    return {};
+  }
+  if (claim_encoding == RELATIVE_PATH) {
+    content_path = ResourceClaim::getContentDirectory(content_repo) + "/" + content_path;
+  }
+
+  if (!readVarint(inStream, file->size_) || !readVarint(inStream, file->offset_)) {
+    return {};
+  }
+
+  file->claim_ = std::make_shared<ResourceClaim>(content_path, content_repo);
+
+  return file;
+}
+
 } /* namespace minifi */
 } /* namespace nifi */
 } /* namespace apache */
@@ -41,14 +41,8 @@ void setDefaultDirectory(std::string path) {
 }
 
 ResourceClaim::ResourceClaim(std::shared_ptr<core::StreamManager<ResourceClaim>> claim_manager)
-    : _contentFullPath([&] {
-        auto contentDirectory = claim_manager->getStoragePath();
-        if (contentDirectory.empty())
-          contentDirectory = default_directory_path;
-
-        // Create the full content path for the content
-        return contentDirectory + "/" + non_repeating_string_generator_.generate();
-      }()),
+    // Create the full content path for the content
+    : _contentFullPath(getContentDirectory(claim_manager) + "/" + non_repeating_string_generator_.generate()),
       claim_manager_(std::move(claim_manager)),
       logger_(logging::LoggerFactory<ResourceClaim>::getLogger()) {
   if (claim_manager_) increaseFlowFileRecordOwnedCount();
@@ -65,6 +59,21 @@ ResourceClaim::~ResourceClaim() {
   if (claim_manager_) decreaseFlowFileRecordOwnedCount();
 }
 
+ResourceClaim::Path ResourceClaim::getRelativePath() const {
+  const std::string directory = getContentDirectory(claim_manager_) + "/";
+  if (directory.size() > 1 && _contentFullPath.size() > directory.size() && _contentFullPath.compare(0, directory.size(), directory) == 0) {
+    return _contentFullPath.substr(directory.size());
+  }
+  return "";
+}
+
+ResourceClaim::Path ResourceClaim::getContentDirectory(const std::shared_ptr<core::StreamManager<ResourceClaim>>& claim_manager) {
+  auto contentDirectory = claim_manager ? claim_manager->getStoragePath() : "";
+  if (contentDirectory.empty())
+    contentDirectory = default_directory_path;
+  return contentDirectory;
+}
+
 } /* namespace minifi */
 } /* namespace nifi */
 } /* namespace apache */
@@ -23,6 +23,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -291,29 +292,42 @@ std::string RESTProtocol::serializeJsonRootPayload(const C2Payload& payload) {
 
   mergePayloadContent(json_payload, payload, alloc);
 
-  for (const auto &nested_payload : payload.getNestedPayloads()) {
-    if (!minimize_updates_ || (minimize_updates_ && !containsPayload(nested_payload))) {
-      rapidjson::Value np_key = getStringValue(nested_payload.getLabel(), alloc);
-      rapidjson::Value np_value = serializeJsonPayload(nested_payload, alloc);
-      if (minimize_updates_) {
-        nested_payloads_.insert(std::pair<std::string, C2Payload>(nested_payload.getLabel(), nested_payload));
-      }
-      json_payload.AddMember(np_key, np_value, alloc);
-    }
-  }
-
   rapidjson::StringBuffer buffer;
-  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
-  json_payload.Accept(writer);
-  return buffer.GetString();
-}
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  if (!json_payload.IsObject()) {
+    json_payload.Accept(writer);
+    return std::string(buffer.GetString(), buffer.GetSize());
+  }
 
-bool RESTProtocol::containsPayload(const C2Payload &o) {
-  auto it = nested_payloads_.find(o.getLabel());
-  if (it != nested_payloads_.end()) {
-    return it->second == o;
+  writer.StartObject();
+  for (const auto &member : json_payload.GetObject()) {
+    writer.Key(member.name.GetString(), member.name.GetStringLength());
+    member.value.Accept(writer);
   }
-  return false;
+  for (const auto &nested_payload : payload.getNestedPayloads()) {
+    // each nested payload is built with its own allocator, which releases it once it is written
+    rapidjson::Document nested_document;
+    rapidjson::Value np_value = serializeJsonPayload(nested_payload, nested_document.GetAllocator());
+    const std::string &label = nested_payload.getLabel();
+    if (!minimize_updates_) {
+      writer.Key(label.c_str(), label.length());
+      np_value.Accept(writer);
+      continue;
+    }
+    rapidjson::StringBuffer np_buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> np_writer(np_buffer);
+    np_value.Accept(np_writer);
+    const size_t hash = std::hash<std::string>()(std::string(np_buffer.GetString(), np_buffer.GetSize()));
+    auto sent = nested_payload_hashes_.find(label);
+    if (sent != nested_payload_hashes_.end() && sent->second == hash) {
+      continue;
+    }
+    nested_payload_hashes_[label] = hash;
+    writer.Key(label.c_str(), label.length());
+    writer.RawValue(np_buffer.GetString(), np_buffer.GetSize(), np_value.GetType());
+  }
+  writer.EndObject();
+  return std::string(buffer.GetString(), buffer.GetSize());
 }
 
 rapidjson::Value RESTProtocol::serializeConnectionQueues(const C2Payload &payload, std::string &label, rapidjson::Document::AllocatorType &alloc) {
@@ -351,66 +365,54 @@ rapidjson::Value RESTProtocol::serializeJsonPayload(const C2Payload &payload, ra
   rapidjson::Value json_payload(payload.isContainer() ? rapidjson::kArrayType : rapidjson::kObjectType);
 
   std::vector<ValueObject> children;
+  // index of the first child of each label, the collapsible payloads are merged into it
+  std::unordered_map<std::string, size_t> child_indices;
 
   bool isQueue = payload.getLabel() == "queues";
 
   for (const auto &nested_payload : payload.getNestedPayloads()) {
     std::string label = nested_payload.getLabel();
-    rapidjson::Value* child_payload = new rapidjson::Value(isQueue ? serializeConnectionQueues(nested_payload, label, alloc) : serializeJsonPayload(nested_payload, alloc));
-
-    if (nested_payload.isCollapsible()) {
-      bool combine = false;
-      for (auto &subordinate : children) {
-        if (subordinate.name == label) {
-          subordinate.values.push_back(child_payload);
-          combine = true;
-          break;
-        }
-      }
-      if (!combine) {
-        ValueObject obj;
-        obj.name = label;
-        obj.values.push_back(child_payload);
-        children.push_back(obj);
-      }
+    rapidjson::Value child_payload(isQueue ? serializeConnectionQueues(nested_payload, label, alloc) : serializeJsonPayload(nested_payload, alloc));
+
+    auto child_index = child_indices.emplace(label, children.size());
+    if (nested_payload.isCollapsible() && !child_index.second) {
+      children[child_index.first->second].values.push_back(std::move(child_payload));
     } else {
       ValueObject obj;
       obj.name = label;
-      obj.values.push_back(child_payload);
-      children.push_back(obj);
+      obj.values.push_back(std::move(child_payload));
+      children.push_back(std::move(obj));
     }
   }
 
-  for (auto child_vector : children) {
+  for (auto &child_vector : children) {
     rapidjson::Value children_json;
     rapidjson::Value newMemberKey = getStringValue(child_vector.name, alloc);
     if (child_vector.values.size() > 1) {
       children_json.SetArray();
-      for (auto child : child_vector.values) {
+      for (auto &child : child_vector.values) {
         if (json_payload.IsArray())
-          json_payload.PushBack(child->Move(), alloc);
+          json_payload.PushBack(child.Move(), alloc);
         else
-          children_json.PushBack(child->Move(), alloc);
+          children_json.PushBack(child.Move(), alloc);
       }
       if (!json_payload.IsArray())
         json_payload.AddMember(newMemberKey, children_json, alloc);
     } else if (child_vector.values.size() == 1) {
-      rapidjson::Value* first = child_vector.values.front();
-      if (first->IsObject() && first->HasMember(newMemberKey)) {
+      rapidjson::Value &first = child_vector.values.front();
+      if (first.IsObject() && first.HasMember(newMemberKey)) {
         if (json_payload.IsArray())
-          json_payload.PushBack((*first)[newMemberKey].Move(), alloc);
+          json_payload.PushBack(first[newMemberKey].Move(), alloc);
         else
-          json_payload.AddMember(newMemberKey, (*first)[newMemberKey].Move(), alloc);
+          json_payload.AddMember(newMemberKey, first[newMemberKey].Move(), alloc);
       } else {
         if (json_payload.IsArray()) {
-          json_payload.PushBack(first->Move(), alloc);
+          json_payload.PushBack(first.Move(), alloc);
         } else {
-          json_payload.AddMember(newMemberKey, first->Move(), alloc);
+          json_payload.AddMember(newMemberKey, first.Move(), alloc);
         }
       }
     }
-    for (rapidjson::Value* child : child_vector.values)
-      delete child;
   }
 
   mergePayloadContent(json_payload, payload, alloc);
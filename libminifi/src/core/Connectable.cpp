@@ -146,10 +146,19 @@ void Connectable::notifyWork() {
 
     if (has_work_.load()) {
       work_condition_.notify_one();
+      std::lock_guard<std::mutex> lock(work_available_mutex_);
+      if (work_notifier_) {
+        work_notifier_();
+      }
     }
   }
 }
 
+void Connectable::setWorkNotifier(std::function<void()> notifier) {
+  std::lock_guard<std::mutex> lock(work_available_mutex_);
+  work_notifier_ = std::move(notifier);
+}
+
 std::set<std::shared_ptr<Connectable>> Connectable::getOutGoingConnections(const std::string &relationship) const {
   std::set<std::shared_ptr<Connectable>> empty;
 
@@ -75,6 +75,9 @@ void ContentSession::commit() {
     if (outStream->write(const_cast<uint8_t*>(resource.second->getBuffer()), size) != size) {
       throw Exception(REPOSITORY_EXCEPTION, "Failed to write new resource: " + resource.first->getContentFullPath());
     }
+    if (outStream->flush() != 0) {
+      throw Exception(REPOSITORY_EXCEPTION, "Failed to flush new resource: " + resource.first->getContentFullPath());
+    }
   }
   for (const auto& resource : extendedResources_) {
     auto outStream = repository_->write(*resource.first, true);
@@ -85,6 +88,9 @@ void ContentSession::commit() {
     if (outStream->write(const_cast<uint8_t*>(resource.second->getBuffer()), size) != size) {
       throw Exception(REPOSITORY_EXCEPTION, "Failed to append to resource: " + resource.first->getContentFullPath());
     }
+    if (outStream->flush() != 0) {
+      throw Exception(REPOSITORY_EXCEPTION, "Failed to flush appended resource: " + resource.first->getContentFullPath());
+    }
   }
 
   managedResources_.clear();
@@ -44,6 +44,9 @@ FlowFile::FlowFile()
       last_queue_date_(0),
       penaltyExpiration_ms_(0),
       event_time_(0),
+      attributes_(std::make_shared<AttributeMap>()),
+      attributes_exposed_(false),
+      attributes_shared_(false),
       claim_(nullptr),
       marked_delete_(false) {
   id_ = numeric_id_generator_->generateId();
@@ -62,7 +65,17 @@ FlowFile& FlowFile::operator=(const FlowFile& other) {
   last_queue_date_ = other.last_queue_date_;
   size_ = other.size_;
   penaltyExpiration_ms_ = other.penaltyExpiration_ms_;
-  attributes_ = other.attributes_;
+  if (attributes_exposed_) {
+    // the map handed out for modification has to stay valid
+    *attributes_ = *other.attributes_;
+  } else if (other.attributes_exposed_) {
+    attributes_ = std::make_shared<AttributeMap>(*other.attributes_);
+    attributes_shared_ = false;
+  } else {
+    attributes_ = other.attributes_;
+    attributes_shared_ = true;
+    other.attributes_shared_ = true;
+  }
   claim_ = other.claim_;
   connection_ = other.connection_;
   return *this;
@@ -143,8 +156,8 @@ std::vector<utils::Identifier> &FlowFile::getlineageIdentifiers() {
 }
 
 bool FlowFile::getAttribute(std::string key, std::string& value) const {
-  auto it = attributes_.find(key);
-  if (it != attributes_.end()) {
+  auto it = attributes_->find(key);
+  if (it != attributes_->end()) {
     value = it->second;
     return true;
   } else {
@@ -162,9 +175,9 @@ uint64_t FlowFile::getOffset() const {
 }
 
 bool FlowFile::removeAttribute(const std::string key) {
-  auto it = attributes_.find(key);
-  if (it != attributes_.end()) {
-    attributes_.erase(it);
+  const AttributeMap& attributes = *attributes_;
+  if (attributes.find(key) != attributes.end()) {
+    mutableAttributes().erase(key);
     return true;
   } else {
     return false;
@@ -172,9 +185,9 @@ bool FlowFile::removeAttribute(const std::string key) {
 }
 
 bool FlowFile::updateAttribute(const std::string key, const std::string value) {
-  auto it = attributes_.find(key);
-  if (it != attributes_.end()) {
-    it->second = value;
+  const AttributeMap& attributes = *attributes_;
+  if (attributes.find(key) != attributes.end()) {
+    mutableAttributes()[key] = value;
     return true;
   } else {
     return false;
@@ -182,16 +195,59 @@ bool FlowFile::updateAttribute(const std::string key, const std::string value) {
 }
 
 bool FlowFile::addAttribute(const std::string& key, const std::string& value) {
-  auto it = attributes_.find(key);
-  if (it != attributes_.end()) {
+  const AttributeMap& attributes = *attributes_;
+  if (attributes.find(key) != attributes.end()) {
     // attribute already there in the map
     return false;
   } else {
-    attributes_[key] = value;
+    mutableAttributes()[key] = value;
     return true;
   }
 }
 
+void FlowFile::inheritAttributes(const FlowFile& other) {
+  if (attributes_exposed_) {
+    // the map handed out for modification has to stay valid
+    for (const auto& attribute : *other.attributes_) {
+      (*attributes_)[attribute.first] = attribute.second;
+    }
+    return;
+  }
+  std::shared_ptr<const AttributeMap> own = attributes_;
+  if (other.attributes_exposed_) {
+    attributes_ = std::make_shared<AttributeMap>(*other.attributes_);
+    attributes_shared_ = false;
+  } else {
+    attributes_ = other.attributes_;
+    attributes_shared_ = true;
+    other.attributes_shared_ = true;
+  }
+  for (const auto& attribute : *own) {
+    if (attributes_->find(attribute.first) == attributes_->end()) {
+      mutableAttributes().insert(attribute);
+    }
+  }
+}
+
+std::shared_ptr<const FlowFile::AttributeMap> FlowFile::shareAttributes() const {
+  if (attributes_exposed_) {
+    // the map handed out for modification is never shared
+    return std::make_shared<AttributeMap>(*attributes_);
+  }
+  attributes_shared_ = true;
+  return attributes_;
+}
+
+FlowFile::AttributeMap& FlowFile::mutableAttributes() {
+  // the use count can't tell whether the other owners are done with the map: they may release it from other
+  // threads (e.g. the provenance writer) without synchronizing with this one, so a map which was ever shared is copied
+  if (attributes_shared_) {
+    attributes_ = std::make_shared<AttributeMap>(*attributes_);
+    attributes_shared_ = false;
+  }
+  return *attributes_;
+}
+
 void FlowFile::setLineageStartDate(const uint64_t date) {
   lineage_start_date_ = date;
 }
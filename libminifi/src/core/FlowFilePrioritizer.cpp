@@ -0,0 +1,124 @@
+/**
+ * @file FlowFilePrioritizer.cpp
+ * FlowFilePrioritizer class implementation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "core/FlowFilePrioritizer.h"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "utils/StringUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+namespace {
+
+template<typename T>
+int compareValues(const T& lhs, const T& rhs) {
+  if (lhs < rhs) return -1;
+  if (rhs < lhs) return 1;
+  return 0;
+}
+
+bool parsePriority(const std::string& value, int64_t& priority) {
+  const std::string trimmed = utils::StringUtils::trim(value);
+  if (trimmed.empty() || trimmed.find_first_not_of("-0123456789") != std::string::npos || trimmed.find('-', 1) != std::string::npos) {
+    return false;
+  }
+  try {
+    priority = std::stoll(trimmed);
+    return true;
+  } catch (const std::exception&) {
+    return false;
+  }
+}
+
+}  // namespace
+
+std::shared_ptr<FlowFilePrioritizer> FlowFilePrioritizer::create(const std::string& class_name) {
+  const std::string trimmed = utils::StringUtils::trim(class_name);
+  const std::string simple_name = trimmed.substr(trimmed.find_last_of('.') + 1);
+  if (simple_name.empty() || simple_name == "FirstInFirstOutPrioritizer") {
+    return nullptr;
+  }
+  if (simple_name == "OldestFlowFileFirstPrioritizer") {
+    return std::make_shared<OldestFlowFileFirstPrioritizer>();
+  }
+  if (simple_name == "NewestFlowFileFirstPrioritizer") {
+    return std::make_shared<NewestFlowFileFirstPrioritizer>();
+  }
+  if (simple_name == "PriorityAttributePrioritizer") {
+    return std::make_shared<PriorityAttributePrioritizer>();
+  }
+  throw std::invalid_argument("Unknown queue prioritizer class " + class_name);
+}
+
+int OldestFlowFileFirstPrioritizer::compare(const FlowFile& lhs, const FlowFile& rhs) const {
+  const int date_comparison = compareValues(lhs.getlineageStartDate(), rhs.getlineageStartDate());
+  if (date_comparison != 0) {
+    return date_comparison;
+  }
+  return compareValues(lhs.getId(), rhs.getId());
+}
+
+int NewestFlowFileFirstPrioritizer::compare(const FlowFile& lhs, const FlowFile& rhs) const {
+  const int date_comparison = compareValues(rhs.getlineageStartDate(), lhs.getlineageStartDate());
+  if (date_comparison != 0) {
+    return date_comparison;
+  }
+  return compareValues(rhs.getId(), lhs.getId());
+}
+
+int PriorityAttributePrioritizer::compare(const FlowFile& lhs, const FlowFile& rhs) const {
+  std::string lhs_priority;
+  std::string rhs_priority;
+  const bool lhs_has_priority = lhs.getAttribute(SpecialFlowAttribute::priority, lhs_priority);
+  const bool rhs_has_priority = rhs.getAttribute(SpecialFlowAttribute::priority, rhs_priority);
+  if (!lhs_has_priority || !rhs_has_priority) {
+    // flow files without a priority are handed out last
+    return compareValues(!lhs_has_priority, !rhs_has_priority);
+  }
+  if (lhs_priority == rhs_priority) {
+    return 0;
+  }
+
+  int64_t lhs_value = 0;
+  int64_t rhs_value = 0;
+  const bool lhs_numeric = parsePriority(lhs_priority, lhs_value);
+  const bool rhs_numeric = parsePriority(rhs_priority, rhs_value);
+  if (lhs_numeric && rhs_numeric) {
+    return compareValues(lhs_value, rhs_value);
+  }
+  if (lhs_numeric || rhs_numeric) {
+    // numeric priorities come before textual ones
+    return lhs_numeric ? -1 : 1;
+  }
+  return compareValues(lhs_priority, rhs_priority);
+}
+
+}  // namespace core
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
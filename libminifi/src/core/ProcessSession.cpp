@@ -82,14 +82,12 @@ std::shared_ptr<core::FlowFile> ProcessSession::create(const std::shared_ptr<cor
   }
 
   if (parent) {
-    // Copy attributes
-    for (const auto& attribute : parent->getAttributes()) {
-      if (attribute.first == SpecialFlowAttribute::ALTERNATE_IDENTIFIER || attribute.first == SpecialFlowAttribute::DISCARD_REASON || attribute.first == SpecialFlowAttribute::UUID) {
-        // Do not copy special attributes from parent
-        continue;
-      }
-      record->setAttribute(attribute.first, attribute.second);
-    }
+    // Copy attributes, they are shared with the parent until either of them modifies them
+    record->inheritAttributes(*parent);
+    // Do not copy special attributes from parent
+    record->removeAttribute(SpecialFlowAttribute::ALTERNATE_IDENTIFIER);
+    record->removeAttribute(SpecialFlowAttribute::DISCARD_REASON);
+    record->removeAttribute(SpecialFlowAttribute::UUID);
     record->setLineageStartDate(parent->getlineageStartDate());
     record->setLineageIdentifiers(parent->getlineageIdentifiers());
     parent->getlineageIdentifiers().push_back(parent->getUUID());
@@ -130,16 +128,12 @@ std::shared_ptr<core::FlowFile> ProcessSession::cloneDuringTransfer(const std::s
   }
   this->_clonedFlowFiles.push_back(record);
   logger_->log_debug("Clone FlowFile with UUID %s during transfer", record->getUUIDStr());
-  // Copy attributes
-  for (const auto& attribute : parent->getAttributes()) {
-    if (attribute.first == SpecialFlowAttribute::ALTERNATE_IDENTIFIER
-        || attribute.first == SpecialFlowAttribute::DISCARD_REASON
-        || attribute.first == SpecialFlowAttribute::UUID) {
-      // Do not copy special attributes from parent
-      continue;
-    }
-    record->setAttribute(attribute.first, attribute.second);
-  }
+  // Copy attributes, they are shared with the parent until either of them modifies them
+  record->inheritAttributes(*parent);
+  // Do not copy special attributes from parent
+  record->removeAttribute(SpecialFlowAttribute::ALTERNATE_IDENTIFIER);
+  record->removeAttribute(SpecialFlowAttribute::DISCARD_REASON);
+  record->removeAttribute(SpecialFlowAttribute::UUID);
   record->setLineageStartDate(parent->getlineageStartDate());
   record->setLineageIdentifiers(parent->getlineageIdentifiers());
   record->getlineageIdentifiers().push_back(parent->getUUID());
@@ -738,7 +732,10 @@ void ProcessSession::commit() {
         if (!record->isDeleted()) {
           continue;
         }
-        if (record->isStored() && process_context_->getFlowFileRepository()->Delete(record->getUUIDStr())) {
+        // the persisted record refers to the claim the FlowFile had before this session modified it
+        auto updated = _updatedFlowFiles.find(record->getUUID());
+        auto storedClaim = updated != _updatedFlowFiles.end() ? updated->second.snapshot->getResourceClaim() : record->getResourceClaim();
+        if (record->isStored() && process_context_->getFlowFileRepository()->Delete(record->getUUIDStr(), storedClaim)) {
           // mark for deletion in the flowFileRepository
           record->setStoredToRepository(false);
         }
@@ -873,7 +870,7 @@ void ProcessSession::persistFlowFilesBeforeTransfer(
       auto original = snapshotIt != modifiedFlowFiles.end() ? snapshotIt->second.snapshot : nullptr;
       if (shouldDropEmptyFiles && ff->getSize() == 0) {
         // the receiver promised to drop this FF, no need for it anymore
-        if (ff->isStored() && flowFileRepo->Delete(ff->getUUIDStr())) {
+        if (ff->isStored() && flowFileRepo->Delete(ff->getUUIDStr(), original ? original->getResourceClaim() : nullptr)) {
           // original must be non-null since this flowFile is already stored in the repos ->
           // must have come from a session->get()
           assert(original);
@@ -922,30 +919,9 @@ std::shared_ptr<core::FlowFile> ProcessSession::get() {
   do {
     std::set<std::shared_ptr<core::FlowFile> > expired;
     std::shared_ptr<core::FlowFile> ret = current->poll(expired);
-    if (!expired.empty()) {
-      // Remove expired flow record
-      for (const auto& record : expired) {
-        std::stringstream details;
-        details << process_context_->getProcessorNode()->getName() << " expire flow record " << record->getUUIDStr();
-        provenance_report_->expire(record, details.str());
-        // there is no rolling back expired FlowFiles
-        if (record->isStored() && process_context_->getFlowFileRepository()->Delete(record->getUUIDStr())) {
-          record->setStoredToRepository(false);
-        }
-      }
-    }
+    removeExpiredFlowFiles(expired);
     if (ret) {
-      // add the flow record to the current process session update map
-      ret->setDeleted(false);
-      std::shared_ptr<FlowFile> snapshot = std::make_shared<FlowFileRecord>();
-      *snapshot = *ret;
-      logger_->log_debug("Create Snapshot FlowFile with UUID %s", snapshot->getUUIDStr());
-      utils::Identifier uuid = ret->getUUID();
-      _updatedFlowFiles[uuid] = {ret, snapshot};
-      auto flow_version = process_context_->getProcessorNode()->getFlowIdentifier();
-      if (flow_version != nullptr) {
-        ret->setAttribute(SpecialFlowAttribute::FLOW_ID, flow_version->getFlowId());
-      }
+      addPolledFlowFile(ret, process_context_->getProcessorNode()->getFlowIdentifier());
       return ret;
     }
     current = std::static_pointer_cast<Connection>(process_context_->getProcessorNode()->pickIncomingConnection());
@@ -954,6 +930,62 @@ std::shared_ptr<core::FlowFile> ProcessSession::get() {
   return nullptr;
 }
 
+std::vector<std::shared_ptr<core::FlowFile>> ProcessSession::get(size_t max_count, uint64_t max_bytes) {
+  std::vector<std::shared_ptr<core::FlowFile>> flows;
+  std::shared_ptr<Connectable> first = process_context_->getProcessorNode()->pickIncomingConnection();
+
+  if (first == nullptr || max_count == 0) {
+    logger_->log_trace("Get is null for %s", process_context_->getProcessorNode()->getName());
+    return flows;
+  }
+
+  const auto flow_version = process_context_->getProcessorNode()->getFlowIdentifier();
+  std::shared_ptr<Connection> current = std::static_pointer_cast<Connection>(first);
+  uint64_t total_bytes = 0;
+
+  do {
+    std::set<std::shared_ptr<core::FlowFile> > expired;
+    const auto polled = current->pollBatch(max_count - flows.size(), max_bytes == 0 ? 0 : max_bytes - total_bytes, expired);
+    removeExpiredFlowFiles(expired);
+    for (const auto& flow : polled) {
+      addPolledFlowFile(flow, flow_version);
+      total_bytes += flow->getSize();
+      flows.push_back(flow);
+    }
+    if (flows.size() >= max_count || (max_bytes != 0 && total_bytes >= max_bytes)) {
+      break;
+    }
+    current = std::static_pointer_cast<Connection>(process_context_->getProcessorNode()->pickIncomingConnection());
+  } while (current != nullptr && current != first);
+
+  return flows;
+}
+
+void ProcessSession::removeExpiredFlowFiles(const std::set<std::shared_ptr<core::FlowFile>>& expired) {
+  for (const auto& record : expired) {
+    std::stringstream details;
+    details << process_context_->getProcessorNode()->getName() << " expire flow record " << record->getUUIDStr();
+    provenance_report_->expire(record, details.str());
+    // there is no rolling back expired FlowFiles
+    if (record->isStored() && process_context_->getFlowFileRepository()->Delete(record->getUUIDStr(), record->getResourceClaim())) {
+      record->setStoredToRepository(false);
+    }
+  }
+}
+
+void ProcessSession::addPolledFlowFile(const std::shared_ptr<core::FlowFile>& flow, const std::shared_ptr<state::FlowIdentifier>& flow_version) {
+  // add the flow record to the current process session update map
+  flow->setDeleted(false);
+  std::shared_ptr<FlowFile> snapshot = std::make_shared<FlowFileRecord>();
+  *snapshot = *flow;
+  logger_->log_debug("Create Snapshot FlowFile with UUID %s", snapshot->getUUIDStr());
+  utils::Identifier uuid = flow->getUUID();
+  _updatedFlowFiles[uuid] = {flow, snapshot};
+  if (flow_version != nullptr) {
+    flow->setAttribute(SpecialFlowAttribute::FLOW_ID, flow_version->getFlowId());
+  }
+}
+
 void ProcessSession::flushContent() {
   content_session_->commit();
 }
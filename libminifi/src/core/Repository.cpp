@@ -17,6 +17,9 @@
  */
 #include "core/Repository.h"
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "io/BufferStream.h"
@@ -24,6 +27,7 @@
 #include "core/logging/Logger.h"
 #include "FlowController.h"
 #include "provenance/Provenance.h"
+#include "utils/GeneralUtils.h"
 
 namespace org {
 namespace apache {
@@ -31,6 +35,23 @@ namespace nifi {
 namespace minifi {
 namespace core {
 
+bool Repository::storeElements(const std::vector<std::shared_ptr<core::SerializableComponent>>& elements) {
+  // each element is serialized straight into the stream handed to MultiPut
+  std::vector<std::pair<std::string, std::unique_ptr<io::BufferStream>>> data;
+  data.reserve(elements.size());
+  bool serialized = true;
+  for (const auto& element : elements) {
+    auto stream = utils::make_unique<io::BufferStream>();
+    if (!element->Serialize(*stream)) {
+      logger_->log_error("Failed to serialize %s to store it in %s", element->getUUIDStr(), name_);
+      serialized = false;
+      continue;
+    }
+    data.emplace_back(element->getUUIDStr(), std::move(stream));
+  }
+  return MultiPut(data) && serialized;
+}
+
 void Repository::start() {
   if (this->purge_period_ <= 0)
     return;
@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 #include "io/FileStream.h"
+#include "io/MappedFileStream.h"
 #include "utils/file/FileUtils.h"
 
 namespace org {
@@ -52,6 +53,11 @@ bool FileSystemRepository::exists(const minifi::ResourceClaim &streamId) {
 }
 
 std::shared_ptr<io::BaseStream> FileSystemRepository::read(const minifi::ResourceClaim &claim) {
+  // content files are only appended to, never truncated, so they can be mapped safely
+  auto mapped_stream = std::make_shared<io::MappedFileStream>(claim.getContentFullPath());
+  if (mapped_stream->isOpen()) {
+    return mapped_stream;
+  }
   return std::make_shared<io::FileStream>(claim.getContentFullPath(), 0, false);
 }
 
@@ -0,0 +1,466 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/repository/SlabContentRepository.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/Property.h"
+#include "io/BufferStream.h"
+#include "utils/file/FileUtils.h"
+#include "Exception.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+namespace repository {
+
+constexpr uint64_t SlabContentRepository::DEFAULT_MAX_SEGMENT_SIZE;
+
+namespace {
+
+const char *SEGMENT_EXTENSION = ".slab";
+
+// record header: type (1 byte), claim path length (4 bytes), content length (8 bytes), all big endian
+constexpr size_t RECORD_HEADER_SIZE = 1 + 4 + 8;
+
+template<typename Integral>
+void encode(uint8_t *buffer, Integral value) {
+  for (size_t i = 0; i < sizeof(Integral); ++i) {
+    buffer[i] = static_cast<uint8_t>(value >> (8 * (sizeof(Integral) - 1 - i)));
+  }
+}
+
+template<typename Integral>
+Integral decode(const uint8_t *buffer) {
+  Integral value = 0;
+  for (size_t i = 0; i < sizeof(Integral); ++i) {
+    value = static_cast<Integral>((value << 8) | buffer[i]);
+  }
+  return value;
+}
+
+/**
+ * Collects the content of a claim in memory and appends it to the repository when closed.
+ */
+class SlabWriteStream : public io::BufferStream {
+ public:
+  SlabWriteStream(std::shared_ptr<SlabContentRepository> repository, ResourceClaim::Path path, bool append)
+      : repository_(std::move(repository)),
+        path_(std::move(path)),
+        append_(append) {
+  }
+
+  ~SlabWriteStream() override {
+    close();
+  }
+
+  int flush() override {
+    if (!repository_ || (append_ && size() == 0)) {
+      return 0;
+    }
+    if (!repository_->append({{path_, append_, getBuffer(), size()}})) {
+      return -1;
+    }
+    // the content written from now on extends what has been stored
+    append_ = true;
+    initialize();
+    return 0;
+  }
+
+  void close() override {
+    if (!repository_) {
+      return;
+    }
+    flush();
+    repository_.reset();
+  }
+
+ private:
+  std::shared_ptr<SlabContentRepository> repository_;
+  ResourceClaim::Path path_;
+  bool append_;
+};
+
+/**
+ * Reads the content of a claim from the segment extents holding it.
+ */
+class SlabReadStream : public io::BaseStream {
+ public:
+  struct Location {
+    std::string segment_path;
+    uint64_t offset;
+    uint64_t length;
+  };
+
+  explicit SlabReadStream(std::vector<Location> locations)
+      : locations_(std::move(locations)),
+        size_(0),
+        position_(0) {
+    for (const auto &location : locations_) {
+      size_ += location.length;
+    }
+  }
+
+  using BaseStream::read;
+  using BaseStream::write;
+
+  size_t size() const override {
+    return gsl::narrow<size_t>(size_);
+  }
+
+  void seek(uint64_t offset) override {
+    position_ = (std::min)(offset, size_);
+  }
+
+  int read(uint8_t *buf, int buflen) override {
+    gsl_Expects(buflen >= 0);
+    int total = 0;
+    uint64_t location_start = 0;
+    for (const auto &location : locations_) {
+      if (total == buflen) {
+        break;
+      }
+      const uint64_t location_end = location_start + location.length;
+      if (position_ < location_end) {
+        if (location.segment_path != open_segment_path_) {
+          segment_.close();
+          segment_.clear();
+          segment_.open(location.segment_path, std::ios::in | std::ios::binary);
+          open_segment_path_ = location.segment_path;
+        }
+        const uint64_t to_read = (std::min)(location_end - position_, static_cast<uint64_t>(buflen - total));
+        segment_.seekg(gsl::narrow<std::streamoff>(location.offset + (position_ - location_start)));
+        if (!segment_.read(reinterpret_cast<char*>(buf + total), gsl::narrow<std::streamsize>(to_read))) {
+          segment_.clear();
+          open_segment_path_.clear();
+          return -1;
+        }
+        total += gsl::narrow<int>(to_read);
+        position_ += to_read;
+      }
+      location_start = location_end;
+    }
+    return total;
+  }
+
+  int write(const uint8_t* /*value*/, int /*size*/) override {
+    return -1;
+  }
+
+ private:
+  std::vector<Location> locations_;
+  uint64_t size_;
+  uint64_t position_;
+  std::ifstream segment_;
+  std::string open_segment_path_;
+};
+
+}  // namespace
+
+SlabContentRepository::Session::Session(std::shared_ptr<ContentRepository> repository) : ContentSession(std::move(repository)) {}
+
+void SlabContentRepository::Session::commit() {
+  std::vector<PendingWrite> writes;
+  writes.reserve(managedResources_.size() + extendedResources_.size());
+  for (const auto& resource : managedResources_) {
+    writes.push_back({resource.first->getContentFullPath(), false, resource.second->getBuffer(), resource.second->size()});
+  }
+  for (const auto& resource : extendedResources_) {
+    writes.push_back({resource.first->getContentFullPath(), true, resource.second->getBuffer(), resource.second->size()});
+  }
+  if (!std::static_pointer_cast<SlabContentRepository>(repository_)->append(writes)) {
+    throw Exception(REPOSITORY_EXCEPTION, "Failed to append content to the active segment");
+  }
+
+  managedResources_.clear();
+  extendedResources_.clear();
+}
+
+std::shared_ptr<ContentSession> SlabContentRepository::createSession() {
+  return std::make_shared<Session>(sharedFromThis());
+}
+
+bool SlabContentRepository::initialize(const std::shared_ptr<minifi::Configure> &configuration) {
+  std::string value;
+  if (configuration->get(Configure::nifi_dbcontent_repository_directory_default, value)) {
+    directory_ = value;
+  } else {
+    directory_ = configuration->getHome() + "/content_repository";
+  }
+  if (configuration->get(Configure::nifi_slab_content_repository_max_segment_size, value)) {
+    Property::StringToInt(value, max_segment_size_);
+  }
+  logger_->log_debug("Slab content repository directory %s, max segment size %" PRIu64, directory_, max_segment_size_);
+  utils::file::FileUtils::create_dir(directory_);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  recover();
+  return active_segment_.is_open();
+}
+
+void SlabContentRepository::stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (active_segment_.is_open()) {
+    active_segment_.close();
+  }
+}
+
+std::string SlabContentRepository::getSegmentPath(uint64_t segment_id) const {
+  return directory_ + "/" + std::to_string(segment_id) + SEGMENT_EXTENSION;
+}
+
+void SlabContentRepository::recover() {
+  std::vector<uint64_t> segment_ids;
+  for (const auto &file : utils::file::FileUtils::list_dir_all(directory_, logger_, false)) {
+    const std::string &name = file.second;
+    const size_t extension_length = std::strlen(SEGMENT_EXTENSION);
+    if (name.size() <= extension_length || name.compare(name.size() - extension_length, extension_length, SEGMENT_EXTENSION) != 0) {
+      continue;
+    }
+    const std::string stem = name.substr(0, name.size() - extension_length);
+    if (!std::all_of(stem.begin(), stem.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+      continue;
+    }
+    segment_ids.push_back(std::stoull(stem));
+  }
+  std::sort(segment_ids.begin(), segment_ids.end());
+
+  for (const auto segment_id : segment_ids) {
+    // the segment being replayed must not be reclaimed while it is read
+    active_segment_id_ = segment_id;
+    replay(segment_id, segments_[segment_id]);
+  }
+
+  // recovered segments are never appended to, so a torn record at their end cannot be followed by valid ones
+  openActiveSegment(segment_ids.empty() ? 1 : segment_ids.back() + 1);
+  for (const auto segment_id : segment_ids) {
+    reclaimIfUnused(segment_id);
+  }
+  logger_->log_info("Recovered %zu claims from %zu segments", index_.size(), segment_ids.size());
+}
+
+void SlabContentRepository::replay(uint64_t segment_id, Segment &segment) {
+  std::ifstream file(getSegmentPath(segment_id), std::ios::in | std::ios::binary);
+  file.seekg(0, std::ios::end);
+  const auto file_size = gsl::narrow<uint64_t>(static_cast<std::streamoff>(file.tellg()));
+  file.seekg(0, std::ios::beg);
+
+  uint64_t position = 0;
+  uint8_t header[RECORD_HEADER_SIZE];
+  while (position + RECORD_HEADER_SIZE <= file_size && file.read(reinterpret_cast<char*>(header), RECORD_HEADER_SIZE)) {
+    const auto type = static_cast<RecordType>(header[0]);
+    const auto path_length = decode<uint32_t>(header + 1);
+    const auto length = decode<uint64_t>(header + 5);
+    const uint64_t data_offset = position + RECORD_HEADER_SIZE + path_length;
+    if (type > RecordType::REMOVE || data_offset + length > file_size) {
+      logger_->log_warn("Segment %s has a torn or corrupt record at offset %" PRIu64 ", ignoring the rest of it", getSegmentPath(segment_id), position);
+      break;
+    }
+    std::string path(path_length, '\0');
+    if (!file.read(&path[0], path_length)) {
+      break;
+    }
+    file.seekg(gsl::narrow<std::streamoff>(length), std::ios::cur);
+    applyRecord(type, path, segment_id, data_offset, length);
+    position = data_offset + length;
+  }
+  segment.size = position;
+}
+
+bool SlabContentRepository::openActiveSegment(uint64_t segment_id) {
+  if (active_segment_.is_open()) {
+    active_segment_.close();
+  }
+  active_segment_.clear();
+  const uint64_t previous_segment_id = active_segment_id_;
+  active_segment_id_ = segment_id;
+  segments_[segment_id];
+  active_segment_.open(getSegmentPath(segment_id), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!active_segment_.is_open()) {
+    logger_->log_error("Failed to open segment %s", getSegmentPath(segment_id));
+    return false;
+  }
+  if (previous_segment_id != segment_id) {
+    reclaimIfUnused(previous_segment_id);
+  }
+  return true;
+}
+
+bool SlabContentRepository::writeRecord(RecordType type, const ResourceClaim::Path &path, const uint8_t *data, uint64_t length, uint64_t &data_offset) {
+  if (segments_[active_segment_id_].size >= max_segment_size_ && !openActiveSegment(active_segment_id_ + 1)) {
+    return false;
+  }
+  auto &segment = segments_[active_segment_id_];
+  uint8_t header[RECORD_HEADER_SIZE];
+  header[0] = static_cast<uint8_t>(type);
+  encode(header + 1, gsl::narrow<uint32_t>(path.size()));
+  encode(header + 5, length);
+  active_segment_.write(reinterpret_cast<const char*>(header), RECORD_HEADER_SIZE);
+  active_segment_.write(path.data(), gsl::narrow<std::streamsize>(path.size()));
+  if (length > 0) {
+    active_segment_.write(reinterpret_cast<const char*>(data), gsl::narrow<std::streamsize>(length));
+  }
+  data_offset = segment.size + RECORD_HEADER_SIZE + path.size();
+  segment.size = data_offset + length;
+  return active_segment_.good();
+}
+
+bool SlabContentRepository::append(const std::vector<PendingWrite> &writes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!active_segment_.is_open()) {
+    return false;
+  }
+  std::vector<Extent> extents;
+  extents.reserve(writes.size());
+  for (const auto &write : writes) {
+    uint64_t data_offset = 0;
+    if (!writeRecord(write.append ? RecordType::APPEND : RecordType::WRITE, write.path, write.data, write.length, data_offset)) {
+      logger_->log_error("Failed to write content of %s to segment %s", write.path, getSegmentPath(active_segment_id_));
+      return false;
+    }
+    extents.push_back({active_segment_id_, data_offset, write.length});
+  }
+  // the content must be readable from the segment files before the claims refer to it
+  if (!active_segment_.flush()) {
+    logger_->log_error("Failed to flush segment %s", getSegmentPath(active_segment_id_));
+    return false;
+  }
+  for (size_t i = 0; i < writes.size(); ++i) {
+    applyRecord(writes[i].append ? RecordType::APPEND : RecordType::WRITE, writes[i].path, extents[i].segment, extents[i].offset, extents[i].length);
+  }
+  return true;
+}
+
+void SlabContentRepository::applyRecord(RecordType type, const ResourceClaim::Path &path, uint64_t segment_id, uint64_t data_offset, uint64_t length) {
+  switch (type) {
+    case RecordType::WRITE:
+      dropExtents(path, segment_id);
+      // fall through
+    case RecordType::APPEND: {
+      auto &extents = index_[path];
+      if (length > 0) {
+        extents.push_back({segment_id, data_offset, length});
+        ++segments_[segment_id].references;
+      }
+      break;
+    }
+    case RecordType::REMOVE:
+      dropExtents(path, segment_id);
+      index_.erase(path);
+      break;
+  }
+}
+
+void SlabContentRepository::dropExtents(const ResourceClaim::Path &path, uint64_t tombstone_segment_id) {
+  auto claim = index_.find(path);
+  if (claim == index_.end()) {
+    return;
+  }
+  std::vector<Extent> extents = std::move(claim->second);
+  claim->second.clear();
+  for (const auto &extent : extents) {
+    auto &segment = segments_[extent.segment];
+    if (extent.segment != tombstone_segment_id) {
+      // the record dropping the extent must outlive it, otherwise the claim would be resurrected on restart
+      segment.tombstone_segments.push_back(tombstone_segment_id);
+      ++segments_[tombstone_segment_id].pending_tombstones;
+    }
+    --segment.references;
+    reclaimIfUnused(extent.segment);
+  }
+}
+
+void SlabContentRepository::reclaimIfUnused(uint64_t segment_id) {
+  auto segment = segments_.find(segment_id);
+  if (segment == segments_.end() || segment_id == active_segment_id_ || segment->second.references > 0 || segment->second.pending_tombstones > 0) {
+    return;
+  }
+  const std::vector<uint64_t> tombstone_segments = std::move(segment->second.tombstone_segments);
+  segments_.erase(segment);
+  logger_->log_debug("Deleting segment %s", getSegmentPath(segment_id));
+  std::remove(getSegmentPath(segment_id).c_str());
+  for (const auto tombstone_segment_id : tombstone_segments) {
+    auto tombstone_segment = segments_.find(tombstone_segment_id);
+    if (tombstone_segment != segments_.end()) {
+      --tombstone_segment->second.pending_tombstones;
+      reclaimIfUnused(tombstone_segment_id);
+    }
+  }
+}
+
+std::shared_ptr<io::BaseStream> SlabContentRepository::write(const minifi::ResourceClaim &claim, bool append) {
+  return std::make_shared<SlabWriteStream>(std::static_pointer_cast<SlabContentRepository>(sharedFromThis()), claim.getContentFullPath(), append);
+}
+
+std::shared_ptr<io::BaseStream> SlabContentRepository::read(const minifi::ResourceClaim &claim) {
+  std::vector<SlabReadStream::Location> locations;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto extents = index_.find(claim.getContentFullPath());
+    if (extents == index_.end()) {
+      return nullptr;
+    }
+    locations.reserve(extents->second.size());
+    for (const auto &extent : extents->second) {
+      locations.push_back({getSegmentPath(extent.segment), extent.offset, extent.length});
+    }
+  }
+  return std::make_shared<SlabReadStream>(std::move(locations));
+}
+
+bool SlabContentRepository::exists(const minifi::ResourceClaim &claim) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return index_.find(claim.getContentFullPath()) != index_.end();
+}
+
+bool SlabContentRepository::remove(const minifi::ResourceClaim &claim) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto path = claim.getContentFullPath();
+  if (index_.find(path) == index_.end() || !active_segment_.is_open()) {
+    return false;
+  }
+  uint64_t data_offset = 0;
+  if (!writeRecord(RecordType::REMOVE, path, nullptr, 0, data_offset) || !active_segment_.flush()) {
+    logger_->log_error("Failed to record the removal of %s", path);
+    return false;
+  }
+  logger_->log_debug("Removed claim %s", path);
+  applyRecord(RecordType::REMOVE, path, active_segment_id_, data_offset, 0);
+  return true;
+}
+
+size_t SlabContentRepository::getSegmentCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return segments_.size();
+}
+
+}  // namespace repository
+}  // namespace core
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
@@ -687,6 +687,16 @@ void YamlConfiguration::parseConnectionYaml(YAML::Node *connectionsNode, core::P
           }
         }
 
+        if (connectionNode["queue prioritizer class"]) {
+          std::string prioritizerClass = connectionNode["queue prioritizer class"].as<std::string>();
+          try {
+            connection->setPrioritizer(core::FlowFilePrioritizer::create(prioritizerClass));
+            logger_->log_debug("parseConnection: queue prioritizer class => [%s]", prioritizerClass);
+          } catch (const std::invalid_argument&) {
+            logger_->log_warn("Unsupported queue prioritizer class %s for connection %s, falling back to first in first out ordering", prioritizerClass, name);
+          }
+        }
+
         if (connection) {
           parent->addConnection(connection);
         }
@@ -0,0 +1,84 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "io/BufferedStream.h"
+
+#include <algorithm>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+constexpr size_t BufferedStream::DEFAULT_CAPACITY;
+
+BufferedStream::BufferedStream(gsl::not_null<BaseStream*> stream, size_t capacity)
+    : stream_(stream),
+      capacity_(capacity) {
+  buffer_.reserve(capacity_);
+}
+
+int BufferedStream::write(const uint8_t *value, int size) {
+  gsl_Expects(size >= 0);
+  const auto length = gsl::narrow<size_t>(size);
+  if (buffer_.size() + length > capacity_) {
+    if (flush() < 0) {
+      return -1;
+    }
+    if (length >= capacity_) {
+      // nothing to coalesce it with, write it as is
+      return stream_->write(value, size);
+    }
+  }
+  buffer_.insert(buffer_.end(), value, value + length);
+  return size;
+}
+
+int BufferedStream::read(uint8_t *buf, int buflen) {
+  if (flush() < 0) {
+    return -1;
+  }
+  return stream_->read(buf, buflen);
+}
+
+int BufferedStream::flush() {
+  if (buffer_.empty()) {
+    return 0;
+  }
+  const int size = gsl::narrow<int>(buffer_.size());
+  const int ret = stream_->write(buffer_.data(), size);
+  buffer_.clear();
+  return ret == size ? 0 : -1;
+}
+
+void BufferedStream::close() {
+  flush();
+  stream_->close();
+}
+
+int BufferedStream::initialize() {
+  buffer_.clear();
+  return stream_->initialize();
+}
+
+}  // namespace io
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
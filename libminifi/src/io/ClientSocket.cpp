@@ -33,6 +33,7 @@
 #include <arpa/inet.h>
 #endif
 
+#include <chrono>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -162,8 +163,6 @@ Socket::Socket(const std::shared_ptr<SocketContext>& /*context*/, std::string ho
       port_(port),
       listeners_(listeners),
       logger_(logging::LoggerFactory<Socket>::getLogger()) {
-  FD_ZERO(&total_list_);
-  FD_ZERO(&read_fds_);
   initialize_socket();
 }
 
@@ -171,9 +170,6 @@ Socket::Socket(const std::shared_ptr<SocketContext>& context, std::string hostna
     : Socket(context, std::move(hostname), port, 0) {
 }
 
-// total_list_ and read_fds_ have to use parentheses for initialization due to CWG 1467
-// http://www.open-std.org/jtc1/sc22/wg21/docs/cwg_defects.html#1467
-// Language defect fix was applied to GCC 5 and Clang 4, but at the time of writing this comment, we support GCC 4.8
 Socket::Socket(Socket &&other) noexcept
     : requested_hostname_{ std::move(other.requested_hostname_) },
       canonical_hostname_{ std::move(other.canonical_hostname_) },
@@ -181,9 +177,7 @@ Socket::Socket(Socket &&other) noexcept
       is_loopback_only_{ other.is_loopback_only_ },
       local_network_interface_{ std::move(other.local_network_interface_) },
       socket_file_descriptor_{ other.socket_file_descriptor_ },
-      total_list_(other.total_list_),
-      read_fds_(other.read_fds_),
-      socket_max_{ other.socket_max_.load() },
+      selector_{ std::move(other.selector_) },
       total_written_{ other.total_written_.load() },
       total_read_{ other.total_read_.load() },
       listeners_{ other.listeners_ },
@@ -201,12 +195,7 @@ Socket& Socket::operator=(Socket &&other) noexcept {
   is_loopback_only_ = util::exchange(other.is_loopback_only_, false);
   local_network_interface_ = util::exchange(other.local_network_interface_, {});
   socket_file_descriptor_ = util::exchange(other.socket_file_descriptor_, INVALID_SOCKET);
-  total_list_ = other.total_list_;
-  FD_ZERO(&other.total_list_);
-  read_fds_ = other.read_fds_;
-  FD_ZERO(&other.read_fds_);
-  socket_max_.exchange(other.socket_max_);
-  other.socket_max_.exchange(0);
+  selector_ = std::move(other.selector_);
   total_written_.exchange(other.total_written_);
   other.total_written_.exchange(0);
   total_read_.exchange(other.total_read_);
@@ -224,6 +213,7 @@ Socket::~Socket() {
 void Socket::close() {
   if (valid_socket(socket_file_descriptor_)) {
     logging::LOG_DEBUG(logger_) << "Closing " << socket_file_descriptor_;
+    selector_.remove(socket_file_descriptor_);
 #ifdef WIN32
     closesocket(socket_file_descriptor_);
 #else
@@ -292,8 +282,11 @@ int8_t Socket::createConnection(const addrinfo* const destination_addresses) {
       logger_->log_info("Connected to %s:%" PRIu16, sockaddr_ntop(current_addr->ai_addr), port_);
     }
 
-    FD_SET(socket_file_descriptor_, &total_list_);
-    socket_max_ = socket_file_descriptor_;
+    if (listeners_ > 0 && !selector_.add(socket_file_descriptor_)) {
+      logger_->log_error("Couldn't watch the listening socket: %s", get_last_socket_error_message());
+      close();
+      return -1;
+    }
     return 0;
   }
   return -1;
@@ -363,9 +356,12 @@ int8_t Socket::createConnection(const addrinfo *, ip4addr &addr) {
     }
   }
 
-  // add the listener to the total set
-  FD_SET(socket_file_descriptor_, &total_list_);
-  socket_max_ = socket_file_descriptor_;
+  // add the listener to the watched descriptors
+  if (listeners_ > 0 && !selector_.add(socket_file_descriptor_)) {
+    logger_->log_error("Couldn't watch the listening socket: %s", get_last_socket_error_message());
+    close();
+    return -1;
+  }
   logger_->log_debug("Created connection with file descriptor %d", socket_file_descriptor_);
   return 0;
 }
@@ -415,46 +411,30 @@ int16_t Socket::select_descriptor(const uint16_t msec) {
     return socket_file_descriptor_;
   }
 
-  struct timeval tv{};
-
-  read_fds_ = total_list_;
+  const auto ready = selector_.wait(msec > 0 ? std::chrono::milliseconds{ msec } : std::chrono::milliseconds{ -1 });
+  if (ready.empty()) {
+    logger_->log_debug("Could not find a suitable file descriptor or select timed out");
+    return -1;
+  }
 
-  tv.tv_sec = msec / 1000;
-  tv.tv_usec = (msec % 1000) * 1000;
+  // connections that are not served now stay readable and are returned by the next call
+  const auto fd = ready.front();
+  if (fd != socket_file_descriptor_) {
+    // data to be received on fd
+    return fd;
+  }
 
+  // we have a new connection
   std::lock_guard<std::recursive_mutex> guard(selection_mutex_);
-
-  if (msec > 0)
-    select(socket_max_ + 1, &read_fds_, nullptr, nullptr, &tv);
-  else
-    select(socket_max_ + 1, &read_fds_, nullptr, nullptr, nullptr);
-
-  for (int i = 0; i <= socket_max_; i++) {
-    if (FD_ISSET(i, &read_fds_)) {
-      if (i == socket_file_descriptor_) {
-        if (listeners_ > 0) {
-          struct sockaddr_storage remoteaddr;  // client address
-          socklen_t addrlen = sizeof remoteaddr;
-          int newfd = accept(socket_file_descriptor_, (struct sockaddr *) &remoteaddr, &addrlen);
-          FD_SET(newfd, &total_list_);  // add to master set
-          if (newfd > socket_max_) {    // keep track of the max
-            socket_max_ = newfd;
-          }
-          return newfd;
-        } else {
-          return socket_file_descriptor_;
-        }
-        // we have a new connection
-      } else {
-        // data to be received on i
-        return i;
-      }
-    }
+  struct sockaddr_storage remoteaddr;  // client address
+  socklen_t addrlen = sizeof remoteaddr;
+  const auto newfd = accept(socket_file_descriptor_, (struct sockaddr *) &remoteaddr, &addrlen);
+  if (!valid_socket(newfd)) {
+    logger_->log_error("accept: %s", get_last_socket_error_message());
+    return -1;
   }
-
-  logger_->log_debug("Could not find a suitable file descriptor or select timed out");
-
-  return -1;
+  selector_.add(newfd);
+  return newfd;
 }
 
 int16_t Socket::setSocketOptions(const SocketDescriptor sock) {
@@ -72,11 +72,32 @@ FileStream::FileStream(const std::string &path, uint32_t offset, bool write_enab
 
 void FileStream::close() {
   std::lock_guard<std::mutex> lock(file_lock_);
+  // close() can't report the failure, which is logged by flushImpl(): callers which have to know whether the
+  // data reached the file flush() before closing
+  flushImpl();
   file_stream_.reset();
 }
 
+int FileStream::flush() {
+  std::lock_guard<std::mutex> lock(file_lock_);
+  return flushImpl() ? 0 : -1;
+}
+
+bool FileStream::flushImpl() {
+  if (!unflushed_writes_ || !file_stream_) {
+    return true;
+  }
+  unflushed_writes_ = false;
+  if (!file_stream_->flush()) {
+    logging::LOG_ERROR(logger_) << "Failed to write buffered data to " << path_;
+    return false;
+  }
+  return true;
+}
+
 void FileStream::seek(uint64_t offset) {
   std::lock_guard<std::mutex> lock(file_lock_);
+  flushImpl();
   offset_ = gsl::narrow<size_t>(offset);
   file_stream_->clear();
   file_stream_->seekg(offset_);
@@ -95,9 +116,7 @@ int FileStream::write(const uint8_t *value, int size) {
       if (offset_ > length_) {
         length_ = offset_;
       }
-      if (!file_stream_->flush()) {
-        return -1;
-      }
+      unflushed_writes_ = true;
       return size;
     } else {
       return -1;
@@ -117,6 +136,9 @@ int FileStream::read(uint8_t *buf, int buflen) {
     if (!file_stream_) {
       return -1;
     }
+    if (unflushed_writes_ && !flushImpl()) {
+      return -1;
+    }
     file_stream_->read(reinterpret_cast<char*>(buf), buflen);
     if ((file_stream_->rdstate() & (file_stream_->eofbit | file_stream_->failbit)) != 0) {
       file_stream_->clear();
@@ -0,0 +1,151 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "io/MappedFileStream.h"
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "io/validation.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+MappedFileStream::MappedFileStream(const std::string &path, uint64_t offset)
+    : path_(path),
+      logger_(logging::LoggerFactory<MappedFileStream>::getLogger()) {
+#ifdef WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    logger_->log_debug("Could not open %s for mapping", path_);
+    return;
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) || static_cast<uint64_t>(file_size.QuadPart) > (std::numeric_limits<size_t>::max)()) {
+    CloseHandle(file);
+    return;
+  }
+  length_ = static_cast<size_t>(file_size.QuadPart);
+  if (length_ > 0) {
+    // the view keeps the mapping and the file alive once it is created
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+      data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+      CloseHandle(mapping);
+    }
+    if (data_ == nullptr) {
+      logger_->log_debug("Could not map %s, error code: %u", path_, GetLastError());
+      CloseHandle(file);
+      length_ = 0;
+      return;
+    }
+  }
+  CloseHandle(file);
+#else
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    logger_->log_debug("Could not open %s for mapping: %s", path_, std::strerror(errno));
+    return;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || static_cast<uint64_t>(file_stat.st_size) > (std::numeric_limits<size_t>::max)()) {
+    ::close(fd);
+    return;
+  }
+  length_ = static_cast<size_t>(file_stat.st_size);
+  if (length_ > 0) {
+    // the mapping keeps the file alive once it is created
+    void *data = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      logger_->log_debug("Could not map %s: %s", path_, std::strerror(errno));
+      ::close(fd);
+      length_ = 0;
+      return;
+    }
+    madvise(data, length_, MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t*>(data);
+  }
+  ::close(fd);
+#endif
+  open_ = true;
+  seek(offset);
+}
+
+void MappedFileStream::close() {
+  if (data_ != nullptr) {
+#ifdef WIN32
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<uint8_t*>(data_), length_);
+#endif
+    data_ = nullptr;
+  }
+  open_ = false;
+  length_ = 0;
+  offset_ = 0;
+}
+
+void MappedFileStream::seek(uint64_t offset) {
+  offset_ = static_cast<size_t>((std::min<uint64_t>)(offset, length_));
+}
+
+bool MappedFileStream::getUnreadView(const uint8_t *&data, size_t &len) const {
+  if (!open_) {
+    return false;
+  }
+  data = data_ + offset_;
+  len = length_ - offset_;
+  return true;
+}
+
+int MappedFileStream::read(uint8_t *buf, int buflen) {
+  gsl_Expects(buflen >= 0);
+  if (buflen == 0) {
+    return 0;
+  }
+  if (IsNullOrEmpty(buf) || !open_) {
+    return -1;
+  }
+  const size_t len = (std::min<size_t>)(buflen, length_ - offset_);
+  if (len > 0) {
+    std::memcpy(buf, data_ + offset_, len);
+    offset_ += len;
+  }
+  return static_cast<int>(len);
+}
+
+}  // namespace io
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
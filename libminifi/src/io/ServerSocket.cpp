@@ -72,8 +72,8 @@ void ServerSocket::registerCallback(std::function<bool()> accept_function, std::
 
 void ServerSocket::close_fd(int fd) {
   std::lock_guard<std::recursive_mutex> guard(selection_mutex_);
+  selector_.remove(fd);
   utils::file::FileUtils::close(fd);
-  FD_CLR(fd, &total_list_);
 }
 
 } /* namespace io */
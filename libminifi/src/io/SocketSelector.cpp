@@ -0,0 +1,290 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "io/SocketSelector.h"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif /* __linux__ */
+
+#include <algorithm>
+#include <array>
+#include <thread>
+#include <utility>
+
+#include "utils/GeneralUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace io {
+
+namespace {
+#ifndef WIN32
+int to_timeout_ms(const std::chrono::milliseconds timeout) {
+  return timeout.count() < 0 ? -1 : static_cast<int>(std::min<std::chrono::milliseconds::rep>(timeout.count(), 0x7fffffff));
+}
+#endif /* !WIN32 */
+
+// like select() without descriptors: callers polling in a loop must not spin while there is nothing to watch
+std::vector<SocketSelector::Descriptor> wait_without_descriptors(const std::chrono::milliseconds timeout) {
+  if (timeout.count() > 0) {
+    std::this_thread::sleep_for(timeout);
+  }
+  return {};
+}
+}  // namespace
+
+#ifdef __linux__
+
+SocketSelector::SocketSelector(SocketSelector &&other) noexcept {
+  std::lock_guard<std::mutex> lock(other.mutex_);
+  epoll_fd_ = utils::exchange(other.epoll_fd_, -1);
+  descriptors_ = std::move(other.descriptors_);
+  other.descriptors_.clear();
+}
+
+SocketSelector& SocketSelector::operator=(SocketSelector &&other) noexcept {
+  if (&other == this) return *this;
+  std::lock(mutex_, other.mutex_);
+  std::lock_guard<std::mutex> lock(mutex_, std::adopt_lock);
+  std::lock_guard<std::mutex> other_lock(other.mutex_, std::adopt_lock);
+  if (epoll_fd_ >= 0) {
+    ::close(epoll_fd_);
+  }
+  epoll_fd_ = utils::exchange(other.epoll_fd_, -1);
+  descriptors_ = std::move(other.descriptors_);
+  other.descriptors_.clear();
+  return *this;
+}
+
+SocketSelector::~SocketSelector() {
+  if (epoll_fd_ >= 0) {
+    ::close(epoll_fd_);
+  }
+}
+
+bool SocketSelector::add(const Descriptor fd) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (epoll_fd_ < 0) {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+      return false;
+    }
+  }
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+    return errno == EEXIST;
+  }
+  // a closed descriptor leaves the epoll set silently, so its number might still be tracked
+  if (std::find(descriptors_.begin(), descriptors_.end(), fd) == descriptors_.end()) {
+    descriptors_.push_back(fd);
+  }
+  return true;
+}
+
+void SocketSelector::remove(const Descriptor fd) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (epoll_fd_ < 0) {
+    return;
+  }
+  // kernels before 2.6.9 require a non-null event even though it is ignored
+  epoll_event event{};
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &event);
+  descriptors_.erase(std::remove(descriptors_.begin(), descriptors_.end(), fd), descriptors_.end());
+}
+
+void SocketSelector::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // the epoll descriptor is kept open, as a concurrent wait might be using it
+  for (const auto fd : descriptors_) {
+    epoll_event event{};
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &event);
+  }
+  descriptors_.clear();
+}
+
+size_t SocketSelector::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return descriptors_.size();
+}
+
+std::vector<SocketSelector::Descriptor> SocketSelector::wait(const std::chrono::milliseconds timeout) {
+  int epoll_fd;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    epoll_fd = descriptors_.empty() ? -1 : epoll_fd_;
+  }
+  if (epoll_fd < 0) {
+    return wait_without_descriptors(timeout);
+  }
+  // the set is not locked during the wait: epoll supports changing it concurrently, the epoll descriptor is only
+  // closed with the selector, and the ready descriptors which don't fit here are reported again by the next wait
+  std::array<epoll_event, 64> events;
+  const int count = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), to_timeout_ms(timeout));
+  std::vector<Descriptor> ready;
+  for (int i = 0; i < count; ++i) {
+    ready.push_back(events[i].data.fd);
+  }
+  return ready;
+}
+
+#else
+
+SocketSelector::SocketSelector(SocketSelector &&other) noexcept {
+  std::lock_guard<std::mutex> lock(other.mutex_);
+  descriptors_ = std::move(other.descriptors_);
+#ifdef WIN32
+  FD_ZERO(&other.descriptors_);
+#else
+  other.descriptors_.clear();
+#endif /* WIN32 */
+}
+
+SocketSelector& SocketSelector::operator=(SocketSelector &&other) noexcept {
+  if (&other == this) return *this;
+  std::lock(mutex_, other.mutex_);
+  std::lock_guard<std::mutex> lock(mutex_, std::adopt_lock);
+  std::lock_guard<std::mutex> other_lock(other.mutex_, std::adopt_lock);
+  descriptors_ = std::move(other.descriptors_);
+#ifdef WIN32
+  FD_ZERO(&other.descriptors_);
+#else
+  other.descriptors_.clear();
+#endif /* WIN32 */
+  return *this;
+}
+
+SocketSelector::~SocketSelector() = default;
+
+#ifdef WIN32
+
+bool SocketSelector::add(const Descriptor fd) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (FD_ISSET(fd, &descriptors_)) {
+    return true;
+  }
+  if (descriptors_.fd_count >= FD_SETSIZE) {
+    WSASetLastError(WSAEMFILE);
+    return false;
+  }
+  FD_SET(fd, &descriptors_);
+  return true;
+}
+
+void SocketSelector::remove(const Descriptor fd) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FD_CLR(fd, &descriptors_);
+}
+
+void SocketSelector::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FD_ZERO(&descriptors_);
+}
+
+size_t SocketSelector::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return descriptors_.fd_count;
+}
+
+std::vector<SocketSelector::Descriptor> SocketSelector::wait(const std::chrono::milliseconds timeout) {
+  fd_set read_fds;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    read_fds = descriptors_;
+  }
+  if (read_fds.fd_count == 0) {
+    return wait_without_descriptors(timeout);
+  }
+  timeval tv{};
+  tv.tv_sec = static_cast<long>(timeout.count() / 1000);  // NOLINT(runtime/int)
+  tv.tv_usec = static_cast<long>((timeout.count() % 1000) * 1000);  // NOLINT(runtime/int)
+  std::vector<Descriptor> ready;
+  if (select(0, &read_fds, nullptr, nullptr, timeout.count() < 0 ? nullptr : &tv) <= 0) {
+    return ready;
+  }
+  // select leaves only the ready descriptors in the set
+  ready.assign(read_fds.fd_array, read_fds.fd_array + read_fds.fd_count);
+  return ready;
+}
+
+#else
+
+bool SocketSelector::add(const Descriptor fd) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = std::find_if(descriptors_.begin(), descriptors_.end(), [fd](const pollfd& descriptor) { return descriptor.fd == fd; });
+  if (it == descriptors_.end()) {
+    pollfd descriptor{};
+    descriptor.fd = fd;
+    descriptor.events = POLLIN;
+    descriptors_.push_back(descriptor);
+  }
+  return true;
+}
+
+void SocketSelector::remove(const Descriptor fd) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  descriptors_.erase(std::remove_if(descriptors_.begin(), descriptors_.end(), [fd](const pollfd& descriptor) { return descriptor.fd == fd; }),
+                     descriptors_.end());
+}
+
+void SocketSelector::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  descriptors_.clear();
+}
+
+size_t SocketSelector::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return descriptors_.size();
+}
+
+std::vector<SocketSelector::Descriptor> SocketSelector::wait(const std::chrono::milliseconds timeout) {
+  std::vector<pollfd> descriptors;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    descriptors = descriptors_;
+  }
+  if (descriptors.empty()) {
+    return wait_without_descriptors(timeout);
+  }
+  std::vector<Descriptor> ready;
+  if (poll(descriptors.data(), descriptors.size(), to_timeout_ms(timeout)) <= 0) {
+    return ready;
+  }
+  for (const auto& descriptor : descriptors) {
+    if (descriptor.revents != 0) {
+      ready.push_back(descriptor.fd);
+    }
+  }
+  return ready;
+}
+
+#endif /* WIN32 */
+
+#endif /* __linux__ */
+
+}  // namespace io
+}  // namespace minifi
+}  // namespace nifi
+}  // namespace apache
+}  // namespace org
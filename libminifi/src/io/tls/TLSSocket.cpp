@@ -22,6 +22,7 @@
 #pragma comment(lib, "Ws2_32.lib")
 #endif  // WIN32
 
+#include <chrono>
 #include <fstream>
 #include <memory>
 #include <utility>
@@ -252,7 +253,7 @@ int16_t TLSSocket::initialize(bool blocking) {
 }
 
 void TLSSocket::close_ssl(int fd) {
-  FD_CLR(fd, &total_list_);  // add to master set
+  selector_.remove(fd);
   if (UNLIKELY(listeners_ > 0)) {
     std::lock_guard<std::mutex> lock(ssl_mutex_);
     auto fd_ssl = ssl_map_[fd];
@@ -269,23 +270,15 @@ int16_t TLSSocket::select_descriptor(const uint16_t msec) {
     return socket_file_descriptor_;
   }
 
-  struct timeval tv;
-
-  read_fds_ = total_list_;
-
-  tv.tv_sec = msec / 1000;
-  tv.tv_usec = (msec % 1000) * 1000;
-
-  std::lock_guard<std::recursive_mutex> guard(selection_mutex_);
-
-  if (msec > 0)
-    select(socket_max_ + 1, &read_fds_, NULL, NULL, &tv);
-  else
-    select(socket_max_ + 1, &read_fds_, NULL, NULL, NULL);
+  if (listeners_ == 0) {
+    // a client waits for its socket while the handshake is in progress
+    selector_.add(socket_file_descriptor_);
+  }
 
-  for (int i = 0; i <= socket_max_; i++) {
-    if (!FD_ISSET(i, &read_fds_)) continue;
+  const auto ready = selector_.wait(msec > 0 ? std::chrono::milliseconds{ msec } : std::chrono::milliseconds{ -1 });
 
+  // connections that are not served now stay readable and are returned by the next call
+  for (const auto i : ready) {
     if (i != socket_file_descriptor_) {
       // data to be received on i
       return i;
@@ -293,15 +286,13 @@ int16_t TLSSocket::select_descriptor(const uint16_t msec) {
 
     // listener can accept a new connection
     if (listeners_ > 0) {
+      std::lock_guard<std::recursive_mutex> guard(selection_mutex_);
       const auto newfd = accept(socket_file_descriptor_, nullptr, nullptr);
       if (!valid_socket(newfd)) {
         logger_->log_error("accept: %s", get_last_socket_error_message());
         return -1;
       }
-      FD_SET(newfd, &total_list_);  // add to master set
-      if (newfd > socket_max_) {    // keep track of the max
-        socket_max_ = newfd;
-      }
+      selector_.add(newfd);
       auto ssl = SSL_new(context_->getContext());
       SSL_set_fd(ssl, newfd);
       auto accept_value = SSL_accept(ssl);
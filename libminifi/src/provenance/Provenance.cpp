@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <list>
 #include "core/Repository.h"
@@ -27,6 +28,7 @@
 #include "core/logging/Logger.h"
 #include "core/Relationship.h"
 #include "FlowController.h"
+#include "utils/gsl.h"
 
 namespace org {
 namespace apache {
@@ -84,7 +86,7 @@ bool ProvenanceEventRecord::DeSerialize(const std::shared_ptr<core::Serializable
   return ret;
 }
 
-bool ProvenanceEventRecord::Serialize(org::apache::nifi::minifi::io::BufferStream& outStream) {
+bool ProvenanceEventRecord::Serialize(org::apache::nifi::minifi::io::OutputStream& outStream) {
   int ret;
 
   ret = outStream.write(this->uuid_);
@@ -139,13 +141,15 @@ bool ProvenanceEventRecord::Serialize(org::apache::nifi::minifi::io::BufferStrea
   }
 
   // write flow attributes
-  uint32_t numAttributes = this->_attributes.size();
+  static const core::FlowFile::AttributeMap no_attributes;
+  const core::FlowFile::AttributeMap &attributes = _attributes ? *_attributes : no_attributes;
+  uint32_t numAttributes = gsl::narrow<uint32_t>(attributes.size());
   ret = outStream.write(numAttributes);
   if (ret != 4) {
     return false;
   }
 
-  for (const auto& itAttribute : _attributes) {
+  for (const auto& itAttribute : attributes) {
     ret = outStream.write(itAttribute.first);
     if (ret <= 0) {
       return false;
@@ -295,6 +299,7 @@ bool ProvenanceEventRecord::DeSerialize(const uint8_t *buffer, const size_t buff
     return false;
   }
 
+  auto attributes = std::make_shared<core::FlowFile::AttributeMap>();
   for (uint32_t i = 0; i < numAttributes; i++) {
     std::string key;
     ret = outStream.read(key);
@@ -306,8 +311,9 @@ bool ProvenanceEventRecord::DeSerialize(const uint8_t *buffer, const size_t buff
     if (ret <= 0) {
       return false;
     }
-    this->_attributes[key] = value;
+    (*attributes)[key] = value;
   }
+  this->_attributes = std::move(attributes);
 
   ret = outStream.read(this->_contentFullPath);
   if (ret <= 0) {
@@ -387,15 +393,9 @@ void ProvenanceReporter::commit() {
     return;
   }
 
-  std::vector<std::pair<std::string, std::unique_ptr<io::BufferStream>>> flowData;
-
-  for (auto& event : _events) {
-    std::unique_ptr<io::BufferStream> stramptr(new io::BufferStream());
-    event->Serialize(*stramptr.get());
-
-    flowData.emplace_back(event->getUUIDStr(), std::move(stramptr));
-  }
-  repo_->MultiPut(flowData);
+  // the repository may serialize the events in the background, they are not modified once committed
+  std::vector<std::shared_ptr<core::SerializableComponent>> elements(_events.begin(), _events.end());
+  repo_->storeElements(elements);
 }
 
 void ProvenanceReporter::create(std::shared_ptr<core::FlowFile> flow, std::string detail) {
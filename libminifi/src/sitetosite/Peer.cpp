@@ -64,6 +64,8 @@ bool SiteToSitePeer::Open() {
 }
 
 void SiteToSitePeer::Close() {
+  if (buffered_stream_ != nullptr)
+    buffered_stream_->flush();
   if (stream_ != nullptr)
     stream_->close();
 }
@@ -109,11 +109,11 @@ int SiteToSiteClient::writeResponse(const std::shared_ptr<Transaction> &transact
 }
 
 bool SiteToSiteClient::transferFlowFiles(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
-  auto flow = session->get();
+  auto flows = session->get(flow_file_batch_size_);
 
   std::shared_ptr<Transaction> transaction = nullptr;
 
-  if (!flow) {
+  if (flows.empty()) {
     return false;
   }
 
@@ -142,31 +142,34 @@ bool SiteToSiteClient::transferFlowFiles(const std::shared_ptr<core::ProcessCont
 
   try {
     while (continueTransaction) {
-      uint64_t startTime = utils::timeutils::getTimeMillis();
-      std::string payload;
-      DataPacket packet(getLogger(), transaction, flow->getAttributes(), payload);
-
-      int16_t resp = send(transactionID, &packet, flow, session);
-      if (resp == -1) {
-        throw Exception(SITE2SITE_EXCEPTION, "Send Failed");
-      }
+      // every FlowFile taken from the session is sent, the batch duration is only checked between batches
+      for (const auto& flow : flows) {
+        uint64_t startTime = utils::timeutils::getTimeMillis();
+        std::string payload;
+        DataPacket packet(getLogger(), transaction, flow->getAttributes(), payload);
+
+        int16_t resp = send(transactionID, &packet, flow, session);
+        if (resp == -1) {
+          throw Exception(SITE2SITE_EXCEPTION, "Send Failed");
+        }
 
-      logger_->log_debug("Site2Site transaction %s send flow record %s", transactionID.to_string(), flow->getUUIDStr());
-      if (resp == 0) {
-        uint64_t endTime = utils::timeutils::getTimeMillis();
-        std::string transitUri = peer_->getURL() + "/" + flow->getUUIDStr();
-        std::string details = "urn:nifi:" + flow->getUUIDStr() + "Remote Host=" + peer_->getHostName();
-        session->getProvenanceReporter()->send(flow, transitUri, details, endTime - startTime, false);
+        logger_->log_debug("Site2Site transaction %s send flow record %s", transactionID.to_string(), flow->getUUIDStr());
+        if (resp == 0) {
+          uint64_t endTime = utils::timeutils::getTimeMillis();
+          std::string transitUri = peer_->getURL() + "/" + flow->getUUIDStr();
+          std::string details = "urn:nifi:" + flow->getUUIDStr() + "Remote Host=" + peer_->getHostName();
+          session->getProvenanceReporter()->send(flow, transitUri, details, endTime - startTime, false);
+        }
+        session->remove(flow);
       }
-      session->remove(flow);
 
       uint64_t transferNanos = utils::timeutils::getTimeNano() - startSendingNanos;
       if (transferNanos > _batchSendNanos)
         break;
 
-      flow = session->get();
+      flows = session->get(flow_file_batch_size_);
 
-      if (!flow) {
+      if (flows.empty()) {
         continueTransaction = false;
       }
     }  // while true
@@ -378,6 +381,9 @@ bool SiteToSiteClient::complete(const utils::Identifier& transactionID) {
     } else {
       logger_->log_debug("Site2Site transaction %s receive finished", transactionID.to_string());
       ret = this->writeResponse(transaction, TRANSACTION_FINISHED, "Finished");
+      if (ret > 0 && peer_->flush() < 0) {
+        ret = -1;
+      }
       if (ret <= 0) {
         return false;
       } else {
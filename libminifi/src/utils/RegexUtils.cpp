@@ -19,6 +19,7 @@
 #include "utils/RegexUtils.h"
 #include "Exception.h"
 #include <iostream>
+#include <utility>
 #include <vector>
 
 namespace org {
@@ -154,6 +155,46 @@ bool Regex::match(const std::string &pattern) {
 #endif
 }
 
+bool Regex::search(const char *begin, const char *end, std::vector<std::pair<const char*, const char*>> &groups) const {
+  groups.clear();
+  if (!valid_) {
+    return false;
+  }
+#ifdef NO_MORE_REGFREEE
+  std::cmatch matches;
+  if (!std::regex_search(begin, end, matches, compiledRegex_)) {
+    return false;
+  }
+  for (const auto &m : matches) {
+    groups.emplace_back(m.first, m.second);
+  }
+  return true;
+#else
+  std::vector<regmatch_t> matches(compiledRegex_.re_nsub + 1);
+#ifdef REG_STARTEND
+  // searches the range in place instead of requiring a null terminated copy
+  matches[0].rm_so = 0;
+  matches[0].rm_eo = end - begin;
+  if (regexec(&compiledRegex_, begin, matches.size(), matches.data(), REG_STARTEND) != 0) {
+    return false;
+  }
+#else
+  const std::string input(begin, end);
+  if (regexec(&compiledRegex_, input.c_str(), matches.size(), matches.data(), 0) != 0) {
+    return false;
+  }
+#endif
+  for (const auto &m : matches) {
+    if (m.rm_so == -1) {
+      groups.emplace_back(end, end);
+    } else {
+      groups.emplace_back(begin + m.rm_so, begin + m.rm_eo);
+    }
+  }
+  return true;
+#endif
+}
+
 const std::vector<std::string>& Regex::getResult() const { return results_; }
 
 const std::string& Regex::getSuffix() const { return suffix_; }
@@ -16,6 +16,11 @@
  */
 
 #include "utils/ThreadPool.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
 #include "core/state/UpdateController.h"
 
 namespace org {
@@ -27,6 +32,8 @@ namespace utils {
 template<typename T>
 void ThreadPool<T>::run_tasks(std::shared_ptr<WorkerThread> thread) {
   thread->is_running_ = true;
+  moodycamel::ProducerToken producer(worker_queue_);
+  moodycamel::ConsumerToken consumer(worker_queue_);
   while (running_.load()) {
     if (UNLIKELY(thread_reduction_count_ > 0)) {
       if (--thread_reduction_count_ >= 0) {
@@ -39,41 +46,74 @@ void ThreadPool<T>::run_tasks(std::shared_ptr<WorkerThread> thread) {
     }
 
     Worker<T> task;
-    if (worker_queue_.dequeueWait(task)) {
-      {
-        std::unique_lock<std::mutex> lock(worker_queue_mutex_);
-        if (!task_status_[task.getIdentifier()]) {
-          continue;
-        }
+    if (dequeue(consumer, task)) {
+      if (task.isCancelled()) {
+        continue;
+      }
+      if (task.getState()) {
+        // this run handles the work that arrived so far
+        task.getState()->work_notified.store(false);
       }
       if (task.run()) {
+        if (task.isCancelled()) {
+          continue;
+        }
         if (task.getNextExecutionTime() <= std::chrono::steady_clock::now()) {
           // it can be rescheduled again as soon as there is a worker available
-          worker_queue_.enqueue(std::move(task));
+          enqueue(producer, std::move(task));
+          continue;
+        }
+        if (task.isWaitingForWork() && task.getState()) {
+          park(producer, std::move(task));
           continue;
         }
         // Task will be put to the delayed queue as next exec time is in the future
         std::unique_lock<std::mutex> lock(worker_queue_mutex_);
-        bool need_to_notify =
-            delayed_worker_queue_.empty() ||
-                task.getNextExecutionTime() < delayed_worker_queue_.top().getNextExecutionTime();
-
-        delayed_worker_queue_.push(std::move(task));
-        if (need_to_notify) {
-          delayed_task_available_.notify_all();
-        }
-      }
-    } else {
-      // This means that the threadpool is running, but the ConcurrentQueue is stopped -> shouldn't happen during normal conditions
-      // Might happen during startup or shutdown for a very short time
-      if (running_.load()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        delay(std::move(task));
       }
     }
   }
   current_workers_--;
 }
 
+template<typename T>
+bool ThreadPool<T>::dequeue(moodycamel::ConsumerToken &consumer, Worker<T> &task) {
+  if (worker_queue_.try_dequeue(consumer, task)) {
+    return true;
+  }
+  std::unique_lock<std::mutex> lock(idle_mutex_);
+  ++idle_workers_;
+  // pairs with the fence in notifyIdleWorker: either we see the new task or the producer sees us idle
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  bool dequeued = false;
+  while (running_ && !(dequeued = worker_queue_.try_dequeue(consumer, task))) {
+    worker_available_.wait(lock);
+  }
+  --idle_workers_;
+  return dequeued;
+}
+
+template<typename T>
+void ThreadPool<T>::enqueue(Worker<T> &&task) {
+  worker_queue_.enqueue(std::move(task));
+  notifyIdleWorker();
+}
+
+template<typename T>
+void ThreadPool<T>::enqueue(moodycamel::ProducerToken &producer, Worker<T> &&task) {
+  worker_queue_.enqueue(producer, std::move(task));
+  notifyIdleWorker();
+}
+
+template<typename T>
+void ThreadPool<T>::notifyIdleWorker() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (idle_workers_ > 0) {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    worker_available_.notify_one();
+  }
+}
+
 template<typename T>
 void ThreadPool<T>::manage_delayed_queue() {
   while (running_) {
@@ -81,30 +121,168 @@ void ThreadPool<T>::manage_delayed_queue() {
 
     // Put the tasks ready to run in the worker queue
     while (!delayed_worker_queue_.empty() &&
-        delayed_worker_queue_.top().getNextExecutionTime() <= std::chrono::steady_clock::now()) {
-      // I'm very sorry for this - committee must has been seriously drunk when the interface of prio queue was submitted.
-      Worker<T> task = std::move(const_cast<Worker<T>&>(delayed_worker_queue_.top()));
-      delayed_worker_queue_.pop();
-      worker_queue_.enqueue(std::move(task));
+        delayed_worker_queue_.front().getNextExecutionTime() <= std::chrono::steady_clock::now()) {
+      std::pop_heap(delayed_worker_queue_.begin(), delayed_worker_queue_.end(), DelayedTaskComparator<T>());
+      enqueue(std::move(delayed_worker_queue_.back()));
+      delayed_worker_queue_.pop_back();
+    }
+    // Wake up the parked tasks that ran out of time waiting for work
+    while (!parked_timeouts_.empty() && parked_timeouts_.front().first <= std::chrono::steady_clock::now()) {
+      std::pop_heap(parked_timeouts_.begin(), parked_timeouts_.end(), ParkedTimeoutComparator<T>());
+      const auto state = std::move(parked_timeouts_.back().second);
+      parked_timeouts_.pop_back();
+      wakeUpParkedTasks(state, true);
     }
-    if (delayed_worker_queue_.empty()) {
+    if (delayed_worker_queue_.empty() && parked_timeouts_.empty()) {
       delayed_task_available_.wait(lock);
     } else {
-      auto wait_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-          delayed_worker_queue_.top().getNextExecutionTime() - std::chrono::steady_clock::now());
+      auto next_time = std::chrono::steady_clock::time_point::max();
+      if (!delayed_worker_queue_.empty()) {
+        next_time = delayed_worker_queue_.front().getNextExecutionTime();
+      }
+      if (!parked_timeouts_.empty()) {
+        next_time = (std::min)(next_time, parked_timeouts_.front().first);
+      }
+      auto wait_time = std::chrono::duration_cast<std::chrono::milliseconds>(next_time - std::chrono::steady_clock::now());
       delayed_task_available_.wait_for(lock, (std::max)(wait_time, std::chrono::milliseconds(1)));
     }
   }
 }
 
+template<typename T>
+void ThreadPool<T>::delay(Worker<T> &&task) {
+  bool need_to_notify =
+      delayed_worker_queue_.empty() ||
+          task.getNextExecutionTime() < delayed_worker_queue_.front().getNextExecutionTime();
+
+  delayed_worker_queue_.push_back(std::move(task));
+  std::push_heap(delayed_worker_queue_.begin(), delayed_worker_queue_.end(), DelayedTaskComparator<T>());
+  if (need_to_notify) {
+    delayed_task_available_.notify_all();
+  }
+}
+
+template<typename T>
+void ThreadPool<T>::park(moodycamel::ProducerToken &producer, Worker<T> &&task) {
+  const auto state = task.getState();
+  const auto wake_up_time = task.getNextExecutionTime();
+  bool add_timeout = false;
+  {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->parked_tasks.push_back(std::move(task));
+    ++state->parked_count;
+    // pairs with notifyWork: either it sees the parked task or we see its notification
+    if (state->work_notified.exchange(false)) {
+      // work arrived while the task was running, don't let it go idle
+      Worker<T> woken = std::move(state->parked_tasks.back());
+      state->parked_tasks.pop_back();
+      --state->parked_count;
+      lock.unlock();
+      woken.wakeUp();
+      enqueue(producer, std::move(woken));
+      return;
+    }
+    add_timeout = !state->timeout_pending;
+    state->timeout_pending = true;
+  }
+  if (add_timeout) {
+    std::lock_guard<std::mutex> lock(worker_queue_mutex_);
+    addParkedTimeout(wake_up_time, state);
+  }
+}
+
+template<typename T>
+void ThreadPool<T>::wakeUpParkedTasks(const std::shared_ptr<TaskState<T>> &state, bool only_due) {
+  std::vector<Worker<T>> woken;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto &parked = state->parked_tasks;
+    const auto now = std::chrono::steady_clock::now();
+    const auto due_begin = std::partition(parked.begin(), parked.end(), [only_due, now](const Worker<T> &task) {
+      return only_due && task.getNextExecutionTime() > now;
+    });
+    woken.reserve(std::distance(due_begin, parked.end()));
+    std::move(due_begin, parked.end(), std::back_inserter(woken));
+    parked.erase(due_begin, parked.end());
+    state->parked_count = parked.size();
+    if (only_due) {
+      // called for the parked timeout of the state, which has been used up now
+      state->timeout_pending = !parked.empty();
+      if (!parked.empty()) {
+        const auto next = std::min_element(parked.begin(), parked.end(), [](const Worker<T> &a, const Worker<T> &b) {
+          return a.getNextExecutionTime() < b.getNextExecutionTime();
+        });
+        addParkedTimeout(next->getNextExecutionTime(), state);
+      }
+    }
+  }
+  for (auto &task : woken) {
+    task.wakeUp();
+    enqueue(std::move(task));
+  }
+}
+
+template<typename T>
+void ThreadPool<T>::addParkedTimeout(std::chrono::steady_clock::time_point time, std::shared_ptr<TaskState<T>> state) {
+  bool need_to_notify = parked_timeouts_.empty() || time < parked_timeouts_.front().first;
+  parked_timeouts_.emplace_back(time, std::move(state));
+  std::push_heap(parked_timeouts_.begin(), parked_timeouts_.end(), ParkedTimeoutComparator<T>());
+  if (need_to_notify) {
+    delayed_task_available_.notify_all();
+  }
+}
+
+template<typename T>
+void ThreadPool<T>::notifyWork(const std::shared_ptr<TaskState<T>> &state) {
+  if (!state->active.load()) {
+    return;
+  }
+  state->work_notified.store(true);
+  if (state->parked_count.load() > 0) {
+    wakeUpParkedTasks(state, false);
+  }
+}
+
+template<typename T>
+void ThreadPool<T>::notifyWork(const TaskId &identifier) {
+  std::shared_ptr<TaskState<T>> state;
+  {
+    std::lock_guard<std::mutex> lock(worker_queue_mutex_);
+    const auto status = task_status_.find(identifier);
+    if (status == task_status_.end()) {
+      return;
+    }
+    state = status->second;
+  }
+  notifyWork(state);
+}
+
+template<typename T>
+std::function<void()> ThreadPool<T>::getWorkNotifier(const TaskId &identifier) {
+  std::lock_guard<std::mutex> lock(worker_queue_mutex_);
+  const auto status = task_status_.find(identifier);
+  if (status == task_status_.end()) {
+    return nullptr;
+  }
+  std::shared_ptr<TaskState<T>> state = status->second;
+  return [this, state] {
+    notifyWork(state);
+  };
+}
+
 template<typename T>
 bool ThreadPool<T>::execute(Worker<T> &&task, std::future<T> &future) {
   {
     std::unique_lock<std::mutex> lock(worker_queue_mutex_);
-    task_status_[task.getIdentifier()] = true;
+    auto &status = task_status_[task.getIdentifier()];
+    if (!status || !status->active.load()) {
+      // tasks stopped earlier keep the old state so they are not revived
+      status = std::make_shared<TaskState<T>>();
+    }
+    task.setState(status);
   }
   future = std::move(task.getPromise()->get_future());
-  worker_queue_.enqueue(std::move(task));
+  enqueue(std::move(task));
 
   task_count_++;
 
@@ -185,7 +363,6 @@ void ThreadPool<T>::start() {
   std::lock_guard<std::recursive_mutex> lock(manager_mutex_);
   if (!running_) {
     running_ = true;
-    worker_queue_.start();
     manager_thread_ = std::thread(&ThreadPool::manageWorkers, this);
 
     std::lock_guard<std::mutex> quee_lock(worker_queue_mutex_);
@@ -196,7 +373,14 @@ void ThreadPool<T>::start() {
 template<typename T>
 void ThreadPool<T>::stopTasks(const TaskId &identifier) {
   std::unique_lock<std::mutex> lock(worker_queue_mutex_);
-  task_status_[identifier] = false;
+  const auto status = task_status_.find(identifier);
+  if (status != task_status_.end()) {
+    status->second->active.store(false);
+    // the parked tasks would be dropped by the workers anyway when they are woken up
+    std::lock_guard<std::mutex> state_lock(status->second->mutex);
+    status->second->parked_tasks.clear();
+    status->second->parked_count = 0;
+  }
 }
 
 template<typename T>
@@ -207,6 +391,12 @@ void ThreadPool<T>::shutdown() {
 
     drain();
 
+    for (const auto &status : task_status_) {
+      // the parked tasks refer back to their state
+      std::lock_guard<std::mutex> state_lock(status.second->mutex);
+      status.second->parked_tasks.clear();
+      status.second->parked_count = 0;
+    }
     task_status_.clear();
     if (manager_thread_.joinable()) {
       manager_thread_.join();
@@ -224,11 +414,12 @@ void ThreadPool<T>::shutdown() {
 
     thread_queue_.clear();
     current_workers_ = 0;
-    while (!delayed_worker_queue_.empty()) {
-      delayed_worker_queue_.pop();
-    }
+    delayed_worker_queue_.clear();
+    parked_timeouts_.clear();
 
-    worker_queue_.clear();
+    Worker<T> task;
+    while (worker_queue_.try_dequeue(task)) {
+    }
   }
 }
 
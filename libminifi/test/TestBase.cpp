@@ -301,7 +301,7 @@ bool TestPlan::runCurrentProcessor(std::function<void(const std::shared_ptr<core
   return gsl::narrow<size_t>(location + 1) < processor_queue_.size();
 }
 
-std::set<std::shared_ptr<provenance::ProvenanceEventRecord>> TestPlan::getProvenanceRecords() {
+std::vector<std::shared_ptr<provenance::ProvenanceEventRecord>> TestPlan::getProvenanceRecords() {
   return process_sessions_.at(location)->getProvenanceReporter()->getEvents();
 }
 
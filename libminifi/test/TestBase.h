@@ -268,7 +268,7 @@ class TestPlan {
 
   bool runCurrentProcessor(std::function<void(const std::shared_ptr<core::ProcessContext>, const std::shared_ptr<core::ProcessSession>)> verify = nullptr);
 
-  std::set<std::shared_ptr<provenance::ProvenanceEventRecord>> getProvenanceRecords();
+  std::vector<std::shared_ptr<provenance::ProvenanceEventRecord>> getProvenanceRecords();
 
   std::shared_ptr<core::FlowFile> getCurrentFlowFile();
 
@@ -21,6 +21,7 @@
 
 #include "core/Core.h"
 #include "FileSystemRepository.h"
+#include "SlabContentRepository.h"
 #include "VolatileContentRepository.h"
 #include "DatabaseContentRepository.h"
 #include "FlowFileRecord.h"
@@ -148,4 +149,7 @@ TEST_CASE("ContentSession behavior") {
   SECTION("DatabaseContentRepository") {
     test_template<core::repository::DatabaseContentRepository>();
   }
+  SECTION("SlabContentRepository") {
+    test_template<core::repository::SlabContentRepository>();
+  }
 }
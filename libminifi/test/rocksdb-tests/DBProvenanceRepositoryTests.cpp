@@ -121,3 +121,47 @@ TEST_CASE("Test time limit", "[timeLimitTest]") {
 
   verifyMaxKeyCount(provdb, 400);
 }
+
+TEST_CASE("Provenance events are written asynchronously", "[asyncWriteTest]") {
+  TestController testController;
+
+  char dirtemplate[] = "/var/tmp/db.XXXXXX";
+  auto temp_dir = testController.createTempDirectory(dirtemplate);
+  REQUIRE(!temp_dir.empty());
+
+  auto provdb = std::make_shared<minifi::provenance::ProvenanceRepository>("TestProvRepo", temp_dir,
+      MAX_PROVENANCE_ENTRY_LIFE_TIME, TEST_MAX_PROVENANCE_STORAGE_SIZE, 1000);
+
+  auto configuration = std::make_shared<org::apache::nifi::minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_provenance_repository_directory_default, temp_dir);
+  configuration->set(minifi::Configure::nifi_provenance_repository_async_write, "true");
+
+  REQUIRE(provdb->initialize(configuration));
+
+  std::vector<std::shared_ptr<core::SerializableComponent>> events;
+  for (size_t i = 0; i < 2500; ++i) {
+    auto event = std::make_shared<minifi::provenance::ProvenanceEventRecord>(minifi::provenance::ProvenanceEventRecord::ProvenanceEventType::CREATE, "componentid", "componenttype");
+    event->setDetails(std::to_string(i));
+    events.push_back(event);
+  }
+  REQUIRE(provdb->storeElements(events));
+
+  // stopping writes the events still queued
+  provdb->stop();
+
+  REQUIRE(provdb->getKeyCount() == events.size());
+  for (const auto& element : events) {
+    auto event = std::static_pointer_cast<minifi::provenance::ProvenanceEventRecord>(element);
+    minifi::provenance::ProvenanceEventRecord restored;
+    restored.setEventId(event->getEventId());
+    REQUIRE(restored.DeSerialize(provdb));
+    REQUIRE(restored.getDetails() == event->getDetails());
+  }
+
+  // once stopped the events are written by the caller
+  auto late_event = std::make_shared<minifi::provenance::ProvenanceEventRecord>(minifi::provenance::ProvenanceEventRecord::ProvenanceEventType::CREATE, "componentid", "componenttype");
+  REQUIRE(provdb->storeElements({late_event}));
+  minifi::provenance::ProvenanceEventRecord restored;
+  restored.setEventId(late_event->getEventId());
+  REQUIRE(restored.DeSerialize(provdb));
+}
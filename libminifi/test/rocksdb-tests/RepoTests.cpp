@@ -16,11 +16,14 @@
  * limitations under the License.
  */
 
+#include <atomic>
 #include <chrono>
 #include <map>
 #include <memory>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "core/Core.h"
 #include "core/repository/AtomicRepoEntries.h"
@@ -187,6 +190,47 @@ TEST_CASE("Test Delete Content ", "[TestFFR4]") {
   LogTestController::getInstance().reset();
 }
 
+TEST_CASE("Delete content of a record without reading it back", "[TestFFR4]") {
+  TestController testController;
+  char format[] = "/var/tmp/testRepo.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+
+  auto repository = std::make_shared<core::repository::FlowFileRepository>("ff", dir, 0, 0, 1);
+
+  const std::string content_path = dir + utils::file::FileUtils::get_separator() + "tstFile.ext";
+  std::ofstream(content_path) << "tempFile";
+
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::FileSystemRepository>();
+
+  repository->initialize(std::make_shared<minifi::Configure>());
+  repository->loadComponent(content_repo);
+
+  {
+    auto claim = std::make_shared<minifi::ResourceClaim>(content_path, content_repo);
+    minifi::FlowFileRecord record;
+    record.setResourceClaim(claim);
+    record.addAttribute("keyA", "valueA");
+    REQUIRE(record.Persist(repository));
+
+    // the stored record is unreadable, the claim passed along is released nevertheless
+    REQUIRE(repository->Put(record.getUUIDStr(), reinterpret_cast<const uint8_t*>("garbage"), 7));
+    REQUIRE(repository->Delete(record.getUUIDStr(), claim));
+    claim->decreaseFlowFileRecordOwnedCount();
+
+    repository->flush();
+
+    std::string value;
+    REQUIRE_FALSE(repository->Get(record.getUUIDStr(), value));
+
+    repository->stop();
+  }
+
+  std::ifstream fileopen(content_path, std::ios::in);
+  REQUIRE(!fileopen.good());
+
+  utils::file::FileUtils::delete_dir(FLOWFILE_CHECKPOINT_DIRECTORY, true);
+}
+
 TEST_CASE("Test Validate Checkpoint ", "[TestFFR5]") {
   TestController testController;
   utils::file::FileUtils::delete_dir(FLOWFILE_CHECKPOINT_DIRECTORY, true);
@@ -331,6 +375,45 @@ TEST_CASE("Test FlowFile Restore", "[TestFFR6]") {
   LogTestController::getInstance().reset();
 }
 
+TEST_CASE("FlowFiles are restored by multiple threads", "[TestFFR6]") {
+  TestController testController;
+  char format[] = "/var/tmp/testRepo.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+
+  auto config = std::make_shared<minifi::Configure>();
+  config->set(minifi::Configure::nifi_flowfile_repository_directory_default, dir);
+  config->set(minifi::Configure::nifi_flowfile_repository_recovery_threads, "4");
+
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::FileSystemRepository>();
+  auto ff_repository = std::make_shared<core::repository::FlowFileRepository>("ff", dir, 0, 0, 1);
+  REQUIRE(ff_repository->initialize(config));
+
+  auto connection = std::make_shared<minifi::Connection>(ff_repository, content_repo, "Input");
+  const uint64_t flow_file_count = 2500;
+  for (uint64_t i = 0; i < flow_file_count; ++i) {
+    minifi::FlowFileRecord record;
+    record.setConnection(connection);
+    REQUIRE(record.Persist(ff_repository));
+  }
+
+  std::map<std::string, std::shared_ptr<core::Connectable>> connectionMap{{connection->getUUIDStr(), connection}};
+  ff_repository->setConnectionMap(connectionMap);
+  ff_repository->loadComponent(content_repo);
+
+  uint64_t recovery_time;
+  REQUIRE_FALSE(ff_repository->getRecoveryTime(recovery_time));
+  ff_repository->start();
+  for (int i = 0; i < 100 && !ff_repository->getRecoveryTime(recovery_time); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ff_repository->stop();
+
+  REQUIRE(ff_repository->getRecoveryTime(recovery_time));
+  REQUIRE(connection->getQueueSize() == flow_file_count);
+
+  utils::file::FileUtils::delete_dir(FLOWFILE_CHECKPOINT_DIRECTORY, true);
+}
+
 TEST_CASE("Flush deleted flowfiles before shutdown", "[TestFFR7]") {
   class TestFlowFileRepository: public core::repository::FlowFileRepository{
    public:
@@ -411,3 +494,56 @@ TEST_CASE("Flush deleted flowfiles before shutdown", "[TestFFR7]") {
     REQUIRE(connection->getQueueSize() == 50);
   }
 }
+
+TEST_CASE("Group commit writes the records of concurrent sessions", "[TestFFR8]") {
+  TestController testController;
+  char format[] = "/var/tmp/testRepo.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto repository = std::make_shared<core::repository::FlowFileRepository>("ff", dir, 0, 0, 1);
+
+  auto config = std::make_shared<minifi::Configure>();
+  config->set(minifi::Configure::nifi_flowfile_repository_group_commit, "true");
+  REQUIRE(repository->initialize(config));
+
+  const int thread_count = 8;
+  const int commits_per_thread = 50;
+  std::vector<std::thread> threads;
+  std::atomic<int> failed_commits{0};
+  for (int thread_index = 0; thread_index < thread_count; ++thread_index) {
+    threads.emplace_back([&repository, &failed_commits, thread_index] {
+      for (int commit_index = 0; commit_index < commits_per_thread; ++commit_index) {
+        std::vector<std::pair<std::string, std::unique_ptr<minifi::io::BufferStream>>> data;
+        for (int record = 0; record < 2; ++record) {
+          const std::string key = std::to_string(thread_index) + "-" + std::to_string(commit_index) + "-" + std::to_string(record);
+          data.emplace_back(key, utils::make_unique<minifi::io::BufferStream>("value of " + key));
+        }
+        if (!repository->MultiPut(data)) {
+          ++failed_commits;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  REQUIRE(failed_commits == 0);
+
+  for (int thread_index = 0; thread_index < thread_count; ++thread_index) {
+    for (int commit_index = 0; commit_index < commits_per_thread; ++commit_index) {
+      const std::string key = std::to_string(thread_index) + "-" + std::to_string(commit_index) + "-1";
+      std::string value;
+      REQUIRE(repository->Get(key, value));
+      REQUIRE(value == "value of " + key);
+    }
+  }
+
+  repository->stop();
+
+  // once stopped the sessions write their records themselves
+  std::vector<std::pair<std::string, std::unique_ptr<minifi::io::BufferStream>>> data;
+  data.emplace_back("after-stop", utils::make_unique<minifi::io::BufferStream>("value"));
+  REQUIRE(repository->MultiPut(data));
+  std::string value;
+  REQUIRE(repository->Get("after-stop", value));
+  REQUIRE(value == "value");
+}
@@ -74,3 +74,62 @@ TEST_CASE_METHOD(RocksDBStreamTest, "Read zero bytes") {
 
   REQUIRE(nonExistingStream.read(nullptr, 0) == -1);
 }
+
+TEST_CASE_METHOD(RocksDBStreamTest, "Content larger than a chunk is read back in pieces") {
+  std::vector<uint8_t> content(minifi::io::RocksDbStream::CHUNK_SIZE * 5 / 2);
+  for (size_t i = 0; i < content.size(); ++i) {
+    content[i] = static_cast<uint8_t>(i % 251);
+  }
+  minifi::io::RocksDbStream outStream("one", gsl::make_not_null(db.get()), true);
+  REQUIRE(outStream.write(content.data(), content.size()) == content.size());
+
+  minifi::io::RocksDbStream inStream("one", gsl::make_not_null(db.get()));
+  REQUIRE(inStream.size() == content.size());
+  std::vector<uint8_t> result;
+  uint8_t buffer[4096];
+  int ret;
+  while ((ret = inStream.read(buffer, sizeof(buffer))) > 0) {
+    result.insert(result.end(), buffer, buffer + ret);
+  }
+  REQUIRE(ret == 0);
+  REQUIRE(result == content);
+
+  inStream.seek(minifi::io::RocksDbStream::CHUNK_SIZE * 2 - 1);
+  REQUIRE(inStream.read(buffer, 2) == 2);
+  REQUIRE(buffer[0] == content[minifi::io::RocksDbStream::CHUNK_SIZE * 2 - 1]);
+  REQUIRE(buffer[1] == content[minifi::io::RocksDbStream::CHUNK_SIZE * 2]);
+}
+
+TEST_CASE_METHOD(RocksDBStreamTest, "Writes are appended to the existing content") {
+  {
+    minifi::io::RocksDbStream outStream("one", gsl::make_not_null(db.get()), true);
+    REQUIRE(outStream.write(reinterpret_cast<const uint8_t*>("first"), 5) == 5);
+  }
+  {
+    minifi::io::RocksDbStream outStream("one", gsl::make_not_null(db.get()), true);
+    REQUIRE(outStream.write(reinterpret_cast<const uint8_t*>("-last"), 5) == 5);
+  }
+
+  minifi::io::RocksDbStream inStream("one", gsl::make_not_null(db.get()));
+  std::vector<uint8_t> buffer;
+  REQUIRE(inStream.read(buffer, 20) == 10);
+  REQUIRE(std::string(buffer.begin(), buffer.begin() + 10) == "first-last");
+
+  inStream.seek(6);
+  REQUIRE(inStream.read(buffer, 4) == 4);
+  REQUIRE(std::string(buffer.begin(), buffer.end()) == "last");
+}
+
+TEST_CASE_METHOD(RocksDBStreamTest, "Content stored as a single value stays readable") {
+  REQUIRE(db->open()->Merge(rocksdb::WriteOptions(), "one", "single").ok());
+  {
+    minifi::io::RocksDbStream outStream("one", gsl::make_not_null(db.get()), true);
+    REQUIRE(outStream.write(reinterpret_cast<const uint8_t*>("-chunk"), 6) == 6);
+  }
+
+  minifi::io::RocksDbStream inStream("one", gsl::make_not_null(db.get()));
+  REQUIRE(inStream.size() == 12);
+  std::vector<uint8_t> buffer;
+  REQUIRE(inStream.read(buffer, 12) == 12);
+  REQUIRE(std::string(buffer.begin(), buffer.end()) == "single-chunk");
+}
@@ -0,0 +1,305 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../TestBase.h"
+#include "Connection.h"
+#include "core/FlowFile.h"
+
+namespace {
+
+std::shared_ptr<minifi::Connection> createConnection() {
+  return std::make_shared<minifi::Connection>(nullptr, nullptr, "connection");
+}
+
+std::shared_ptr<core::FlowFile> createFlowFile(uint64_t size) {
+  auto flow_file = std::make_shared<core::FlowFile>();
+  flow_file->setSize(size);
+  return flow_file;
+}
+
+std::shared_ptr<core::FlowFile> createFlowFileWithPriority(const std::string& priority) {
+  auto flow_file = createFlowFile(1);
+  flow_file->setAttribute(core::SpecialFlowAttribute::priority, priority);
+  return flow_file;
+}
+
+std::vector<std::shared_ptr<core::FlowFile>> pollAll(minifi::Connection& connection) {
+  std::vector<std::shared_ptr<core::FlowFile>> flow_files;
+  std::set<std::shared_ptr<core::FlowFile>> expired;
+  while (auto flow_file = connection.poll(expired)) {
+    flow_files.push_back(flow_file);
+  }
+  return flow_files;
+}
+
+}  // namespace
+
+TEST_CASE("Connection tracks the number and size of queued flow files", "[connection]") {
+  auto connection = createConnection();
+  REQUIRE(connection->isEmpty());
+  REQUIRE(connection->getQueueSize() == 0);
+
+  connection->put(createFlowFile(10));
+  std::vector<std::shared_ptr<core::FlowFile>> flow_files{createFlowFile(20), createFlowFile(30)};
+  connection->multiPut(flow_files);
+
+  REQUIRE_FALSE(connection->isEmpty());
+  REQUIRE(connection->getQueueSize() == 3);
+  REQUIRE(connection->getQueueDataSize() == 60);
+
+  std::set<std::shared_ptr<core::FlowFile>> expired;
+  REQUIRE(connection->poll(expired)->getSize() == 10);
+  REQUIRE(connection->poll(expired)->getSize() == 20);
+  REQUIRE(connection->poll(expired)->getSize() == 30);
+  REQUIRE_FALSE(connection->poll(expired));
+  REQUIRE(expired.empty());
+  REQUIRE(connection->isEmpty());
+  REQUIRE(connection->getQueueDataSize() == 0);
+}
+
+TEST_CASE("Connection applies back pressure by count and by size", "[connection]") {
+  auto connection = createConnection();
+  REQUIRE_FALSE(connection->isFull());
+
+  connection->setMaxQueueSize(2);
+  connection->put(createFlowFile(1));
+  REQUIRE_FALSE(connection->isFull());
+  connection->put(createFlowFile(1));
+  REQUIRE(connection->isFull());
+
+  connection->drain(false);
+  REQUIRE(connection->isEmpty());
+  REQUIRE_FALSE(connection->isFull());
+
+  connection->setMaxQueueSize(0);
+  connection->setMaxQueueDataSize(100);
+  connection->put(createFlowFile(99));
+  REQUIRE_FALSE(connection->isFull());
+  connection->put(createFlowFile(1));
+  REQUIRE(connection->isFull());
+}
+
+TEST_CASE("Connection does not hand out penalized flow files", "[connection]") {
+  auto connection = createConnection();
+  auto flow_file = createFlowFile(5);
+  flow_file->setPenaltyExpiration(utils::timeutils::getTimeMillis() + 60000);
+  connection->put(flow_file);
+
+  std::set<std::shared_ptr<core::FlowFile>> expired;
+  REQUIRE_FALSE(connection->poll(expired));
+  REQUIRE(connection->getQueueSize() == 1);
+  REQUIRE(connection->getQueueDataSize() == 5);
+  REQUIRE_FALSE(connection->isEmpty());
+  REQUIRE_FALSE(connection->isWorkAvailable());
+
+  connection->drain(false);
+  REQUIRE(connection->isEmpty());
+  REQUIRE(connection->getQueueDataSize() == 0);
+}
+
+TEST_CASE("Penalized flow files do not block the ones queued behind them", "[connection]") {
+  auto connection = createConnection();
+  auto penalized = createFlowFile(1);
+  penalized->setPenaltyExpiration(utils::timeutils::getTimeMillis() + 100);
+  auto ready = createFlowFile(2);
+  connection->put(penalized);
+  connection->put(ready);
+
+  std::set<std::shared_ptr<core::FlowFile>> expired;
+  REQUIRE(connection->poll(expired) == ready);
+  REQUIRE_FALSE(connection->poll(expired));
+  REQUIRE(connection->getQueueSize() == 1);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  REQUIRE(connection->isWorkAvailable());
+  REQUIRE(connection->poll(expired) == penalized);
+  REQUIRE(connection->isEmpty());
+  REQUIRE(expired.empty());
+}
+
+TEST_CASE("Connection can be fed and drained by multiple threads", "[connection]") {
+  auto connection = createConnection();
+  const size_t producer_count = 4;
+  const size_t flow_files_per_producer = 1000;
+
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < producer_count; ++i) {
+    producers.emplace_back([&connection] {
+      for (size_t j = 0; j < flow_files_per_producer; ++j) {
+        connection->put(createFlowFile(1));
+      }
+    });
+  }
+
+  std::atomic<size_t> consumed{0};
+  std::vector<std::thread> consumers;
+  for (size_t i = 0; i < producer_count; ++i) {
+    consumers.emplace_back([&connection, &consumed] {
+      std::set<std::shared_ptr<core::FlowFile>> expired;
+      while (consumed < producer_count * flow_files_per_producer) {
+        if (connection->poll(expired)) {
+          ++consumed;
+        }
+      }
+    });
+  }
+
+  for (auto& producer : producers) producer.join();
+  for (auto& consumer : consumers) consumer.join();
+
+  REQUIRE(consumed == producer_count * flow_files_per_producer);
+  REQUIRE(connection->isEmpty());
+  REQUIRE(connection->getQueueDataSize() == 0);
+}
+
+TEST_CASE("Connection polls flow files in batches limited by count and size", "[connection][pollBatch]") {
+  auto connection = createConnection();
+  auto penalized = createFlowFile(1);
+  penalized->setPenaltyExpiration(utils::timeutils::getTimeMillis() + 60000);
+  connection->put(penalized);
+  for (uint64_t size = 1; size <= 10; ++size) {
+    connection->put(createFlowFile(size));
+  }
+
+  std::set<std::shared_ptr<core::FlowFile>> expired;
+  REQUIRE(connection->pollBatch(0, 0, expired).empty());
+
+  auto batch = connection->pollBatch(3, 0, expired);
+  REQUIRE(batch.size() == 3);
+  REQUIRE(batch[0]->getSize() == 1);
+  REQUIRE(batch[2]->getSize() == 3);
+  REQUIRE(batch[0]->getConnection() == connection);
+
+  // the size limit is reached by the flow file of size 5
+  batch = connection->pollBatch(10, 8, expired);
+  REQUIRE(batch.size() == 2);
+  REQUIRE(connection->getQueueSize() == 6);
+
+  batch = connection->pollBatch(100, 0, expired);
+  REQUIRE(batch.size() == 5);
+  REQUIRE(connection->getQueueSize() == 1);
+  REQUIRE(connection->getQueueDataSize() == 1);
+  REQUIRE(expired.empty());
+}
+
+TEST_CASE("FlowFilePrioritizer is created from the NiFi class name", "[connection][prioritizer]") {
+  REQUIRE_FALSE(core::FlowFilePrioritizer::create(""));
+  REQUIRE_FALSE(core::FlowFilePrioritizer::create("org.apache.nifi.prioritizer.FirstInFirstOutPrioritizer"));
+  REQUIRE(std::dynamic_pointer_cast<core::OldestFlowFileFirstPrioritizer>(core::FlowFilePrioritizer::create("org.apache.nifi.prioritizer.OldestFlowFileFirstPrioritizer")));
+  REQUIRE(std::dynamic_pointer_cast<core::NewestFlowFileFirstPrioritizer>(core::FlowFilePrioritizer::create("NewestFlowFileFirstPrioritizer")));
+  REQUIRE(std::dynamic_pointer_cast<core::PriorityAttributePrioritizer>(core::FlowFilePrioritizer::create("org.apache.nifi.prioritizer.PriorityAttributePrioritizer")));
+  REQUIRE_THROWS_AS(core::FlowFilePrioritizer::create("org.apache.nifi.prioritizer.NoSuchPrioritizer"), std::invalid_argument);
+}
+
+TEST_CASE("Connection hands out flow files in the order of its prioritizer", "[connection][prioritizer]") {
+  auto connection = createConnection();
+  auto oldest = createFlowFile(1);
+  oldest->setLineageStartDate(1000);
+  auto middle = createFlowFile(1);
+  middle->setLineageStartDate(2000);
+  auto newest = createFlowFile(1);
+  newest->setLineageStartDate(3000);
+
+  SECTION("Oldest first") {
+    connection->setPrioritizer(std::make_shared<core::OldestFlowFileFirstPrioritizer>());
+    connection->put(middle);
+    connection->put(newest);
+    connection->put(oldest);
+    REQUIRE(pollAll(*connection) == (std::vector<std::shared_ptr<core::FlowFile>>{oldest, middle, newest}));
+  }
+
+  SECTION("Newest first") {
+    connection->setPrioritizer(std::make_shared<core::NewestFlowFileFirstPrioritizer>());
+    connection->put(middle);
+    connection->put(oldest);
+    connection->put(newest);
+    REQUIRE(pollAll(*connection) == (std::vector<std::shared_ptr<core::FlowFile>>{newest, middle, oldest}));
+  }
+  REQUIRE(connection->isEmpty());
+}
+
+TEST_CASE("PriorityAttributePrioritizer prefers low numeric priorities", "[connection][prioritizer]") {
+  auto connection = createConnection();
+  connection->setPrioritizer(std::make_shared<core::PriorityAttributePrioritizer>());
+
+  auto none = createFlowFile(1);
+  auto text = createFlowFileWithPriority("urgent");
+  auto ten = createFlowFileWithPriority("10");
+  auto two = createFlowFileWithPriority("2");
+  auto another_two = createFlowFileWithPriority(" 2 ");
+  auto negative = createFlowFileWithPriority("-5");
+  std::vector<std::shared_ptr<core::FlowFile>> flow_files{none, text, ten, two, another_two, negative};
+  connection->multiPut(flow_files);
+
+  REQUIRE(pollAll(*connection) == (std::vector<std::shared_ptr<core::FlowFile>>{negative, two, another_two, ten, text, none}));
+}
+
+TEST_CASE("Penalized flow files rejoin a prioritized connection at their priority", "[connection][prioritizer]") {
+  auto connection = createConnection();
+  connection->setPrioritizer(std::make_shared<core::PriorityAttributePrioritizer>());
+
+  auto penalized = createFlowFileWithPriority("1");
+  penalized->setPenaltyExpiration(utils::timeutils::getTimeMillis() + 100);
+  auto low = createFlowFileWithPriority("5");
+  connection->put(penalized);
+
+  std::set<std::shared_ptr<core::FlowFile>> expired;
+  REQUIRE_FALSE(connection->poll(expired));
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  connection->put(low);
+  REQUIRE(pollAll(*connection) == (std::vector<std::shared_ptr<core::FlowFile>>{penalized, low}));
+}
+
+TEST_CASE("Connection enqueue and dequeue cost with and without prioritizer", "[.][benchmark]") {
+  const size_t flow_file_count = 100000;
+  std::vector<std::shared_ptr<core::FlowFile>> flow_files;
+  flow_files.reserve(flow_file_count);
+  for (size_t i = 0; i < flow_file_count; ++i) {
+    flow_files.push_back(createFlowFileWithPriority(std::to_string(i % 100)));
+  }
+
+  const auto measure = [&flow_files](const std::string& name, const std::shared_ptr<core::FlowFilePrioritizer>& prioritizer) {
+    auto connection = createConnection();
+    connection->setPrioritizer(prioritizer);
+    std::set<std::shared_ptr<core::FlowFile>> expired;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& flow_file : flow_files) {
+      connection->put(flow_file);
+    }
+    const auto enqueued = std::chrono::steady_clock::now();
+    while (connection->poll(expired)) {}
+    const auto dequeued = std::chrono::steady_clock::now();
+
+    const auto per_flow_file = [&flow_files](std::chrono::steady_clock::duration duration) {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / static_cast<int64_t>(flow_files.size());
+    };
+    std::cout << name << ": enqueue " << per_flow_file(enqueued - start) << " ns, dequeue " << per_flow_file(dequeued - enqueued) << " ns per flow file" << std::endl;
+  };
+
+  measure("FirstInFirstOut", nullptr);
+  measure("OldestFlowFileFirst", std::make_shared<core::OldestFlowFileFirstPrioritizer>());
+  measure("PriorityAttribute", std::make_shared<core::PriorityAttributePrioritizer>());
+}
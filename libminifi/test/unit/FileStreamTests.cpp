@@ -16,7 +16,9 @@
  * limitations under the License.
  */
 
+#include <chrono>
 #include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -262,3 +264,58 @@ TEST_CASE("Read zero bytes") {
   minifi::io::FileStream stream(utils::file::concat_path(dir, "test.txt"), 0, true);
   REQUIRE(stream.read(nullptr, 0) == 0);
 }
+
+TEST_CASE("Buffered writes reach the file on flush and close") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  const auto path = utils::file::concat_path(dir, "test.txt");
+  const auto file_content = [&path] {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+  };
+
+  {
+    minifi::io::FileStream stream(path);
+    REQUIRE(stream.write(reinterpret_cast<const uint8_t*>("first"), 5) == 5);
+    REQUIRE(stream.flush() == 0);
+    REQUIRE(file_content() == "first");
+    REQUIRE(stream.write(reinterpret_cast<const uint8_t*>(" second"), 7) == 7);
+    REQUIRE(stream.size() == 12);
+  }
+  REQUIRE(file_content() == "first second");
+
+  minifi::io::FileStream stream(path, 0, true);
+  stream.seek(stream.size());
+  REQUIRE(stream.write(reinterpret_cast<const uint8_t*>(" third"), 6) == 6);
+  stream.seek(0);
+  std::vector<uint8_t> buffer;
+  REQUIRE(stream.read(buffer, stream.size()) == 18);
+  REQUIRE(std::string(buffer.begin(), buffer.end()) == "first second third");
+}
+
+TEST_CASE("FileStream throughput of small chunk writes", "[.][benchmark]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  const size_t chunk_size = 4096;
+  const size_t total_size = 64 * 1024 * 1024;
+  const std::vector<uint8_t> chunk(chunk_size, 'x');
+
+  const auto measure = [&](const std::string& name, bool flush_every_chunk) {
+    minifi::io::FileStream stream(utils::file::concat_path(dir, name));
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t written = 0; written < total_size; written += chunk_size) {
+      REQUIRE(stream.write(chunk.data(), static_cast<int>(chunk_size)) == static_cast<int>(chunk_size));
+      if (flush_every_chunk) {
+        REQUIRE(stream.flush() == 0);
+      }
+    }
+    stream.close();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << (elapsed > 0 ? total_size / elapsed : 0) << " MB/s" << std::endl;
+  };
+
+  measure("flush_every_chunk", true);
+  measure("buffered", false);
+}
@@ -20,6 +20,8 @@
 #include <string>
 
 #include "io/BaseStream.h"
+#include "io/BufferStream.h"
+#include "core/repository/FileSystemRepository.h"
 #include "serialization/FlowFileV3Serializer.h"
 #include "serialization/PayloadSerializer.h"
 #include "core/FlowFile.h"
@@ -83,3 +85,87 @@ TEST_CASE("FFv3 Serializer", "[testFFv3]") {
   REQUIRE(serialized == expected);
 }
 
+
+TEST_CASE("FlowFileRecord round trip", "[testFlowFileRecord]") {
+  TestController testController;
+  char format[] = "/tmp/ffrecord.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  auto config = std::make_shared<minifi::Configure>();
+  config->set(minifi::Configure::nifi_dbcontent_repository_directory_default, dir);
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::FileSystemRepository>();
+  REQUIRE(content_repo->initialize(config));
+
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  auto flowFile = createEmptyFlowFile();
+  flowFile->setResourceClaim(claim);
+  flowFile->setSize(300);
+  flowFile->setOffset(20);
+  flowFile->setLineageStartDate(1600000000000);
+  flowFile->addAttribute(core::SpecialFlowAttribute::MIME_TYPE, "text/plain");
+  flowFile->addAttribute("custom", "value");
+  flowFile->addAttribute("", "empty key");
+
+  minifi::io::BufferStream stream;
+  REQUIRE(flowFile->Serialize(stream));
+
+  // interned keys and the content directory are not repeated in the record
+  const std::string serialized(reinterpret_cast<const char*>(stream.getBuffer()), stream.size());
+  REQUIRE(serialized.find(core::SpecialFlowAttribute::MIME_TYPE) == std::string::npos);
+  REQUIRE(serialized.find(dir) == std::string::npos);
+
+  utils::Identifier container;
+  auto restored = minifi::FlowFileRecord::DeSerialize(stream.getBuffer(), stream.size(), content_repo, container);
+  REQUIRE(restored);
+  REQUIRE(container.isNil());
+  REQUIRE(restored->getUUID() == flowFile->getUUID());
+  REQUIRE(restored->getEventTime() == flowFile->getEventTime());
+  REQUIRE(restored->getEntryDate() == flowFile->getEntryDate());
+  REQUIRE(restored->getlineageStartDate() == 1600000000000);
+  REQUIRE(restored->getSize() == 300);
+  REQUIRE(restored->getOffset() == 20);
+  std::string value;
+  REQUIRE(restored->getAttribute(core::SpecialFlowAttribute::MIME_TYPE, value));
+  REQUIRE(value == "text/plain");
+  REQUIRE(restored->getAttribute("custom", value));
+  REQUIRE(value == "value");
+  REQUIRE(restored->getAttribute("", value));
+  REQUIRE(value == "empty key");
+  REQUIRE(restored->getContentFullPath() == claim->getContentFullPath());
+
+  REQUIRE_FALSE(minifi::FlowFileRecord::DeSerialize(stream.getBuffer(), stream.size() - 1, content_repo, container));
+}
+
+TEST_CASE("FlowFileRecord reads the original format", "[testFlowFileRecord]") {
+  const utils::Identifier uuid = utils::IdGenerator::getIdGenerator()->generate();
+  minifi::io::BufferStream stream;
+  stream.write(uint64_t{1600000000000});  // event time
+  stream.write(uint64_t{1600000000001});  // entry date
+  stream.write(uint64_t{1600000000002});  // lineage start date
+  stream.write(uuid);
+  stream.write(utils::Identifier{});  // container
+  stream.write(uint32_t{2});  // number of attributes
+  stream.write(core::SpecialFlowAttribute::FILENAME, true);
+  stream.write("file.txt", true);
+  stream.write("custom", true);
+  stream.write("value", true);
+  stream.write("/content/claim");
+  stream.write(uint64_t{300});  // size
+  stream.write(uint64_t{20});  // offset
+
+  utils::Identifier container;
+  auto restored = minifi::FlowFileRecord::DeSerialize(stream.getBuffer(), stream.size(), nullptr, container);
+  REQUIRE(restored);
+  REQUIRE(container.isNil());
+  REQUIRE(restored->getUUID() == uuid);
+  REQUIRE(restored->getEventTime() == 1600000000000);
+  REQUIRE(restored->getEntryDate() == 1600000000001);
+  REQUIRE(restored->getlineageStartDate() == 1600000000002);
+  REQUIRE(restored->getSize() == 300);
+  REQUIRE(restored->getOffset() == 20);
+  std::string value;
+  REQUIRE(restored->getAttribute(core::SpecialFlowAttribute::FILENAME, value));
+  REQUIRE(value == "file.txt");
+  REQUIRE(restored->getAttribute("custom", value));
+  REQUIRE(value == "value");
+  REQUIRE(restored->getContentFullPath() == "/content/claim");
+}
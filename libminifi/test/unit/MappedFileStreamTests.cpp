@@ -0,0 +1,99 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "io/BufferStream.h"
+#include "io/FileStream.h"
+#include "io/MappedFileStream.h"
+#include "io/StreamPipe.h"
+#include "../TestBase.h"
+
+namespace {
+
+std::string createFile(TestController& testController, const std::string& content) {
+  char format[] = "/tmp/mapped.XXXXXX";
+  const std::string path = testController.createTempDirectory(format) + "/content";
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+  return path;
+}
+
+}  // namespace
+
+TEST_CASE("MappedFileStream reads and seeks", "[MappedFileStream]") {
+  TestController testController;
+  const std::string path = createFile(testController, "tempFile");
+
+  minifi::io::MappedFileStream stream(path);
+  REQUIRE(stream.isOpen());
+  REQUIRE(stream.size() == 8);
+
+  std::vector<uint8_t> buffer;
+  REQUIRE(stream.read(buffer, 4) == 4);
+  REQUIRE(std::string(buffer.begin(), buffer.end()) == "temp");
+
+  const uint8_t* view;
+  size_t view_size;
+  REQUIRE(stream.getUnreadView(view, view_size));
+  REQUIRE(std::string(reinterpret_cast<const char*>(view), view_size) == "File");
+
+  REQUIRE(stream.read(buffer, 10) == 4);
+  REQUIRE(std::string(buffer.begin(), buffer.begin() + 4) == "File");
+  REQUIRE(stream.read(buffer, 10) == 0);
+
+  stream.seek(2);
+  REQUIRE(stream.read(buffer, 2) == 2);
+  REQUIRE(std::string(buffer.begin(), buffer.end()) == "mp");
+
+  stream.seek(100);
+  REQUIRE(stream.read(buffer, 2) == 0);
+
+  REQUIRE(stream.write(reinterpret_cast<const uint8_t*>("data"), 4) == -1);
+}
+
+TEST_CASE("MappedFileStream handles empty and missing files", "[MappedFileStream]") {
+  TestController testController;
+  const std::string path = createFile(testController, "");
+
+  minifi::io::MappedFileStream empty_stream(path);
+  REQUIRE(empty_stream.isOpen());
+  REQUIRE(empty_stream.size() == 0);
+  uint8_t buffer[4];
+  REQUIRE(empty_stream.read(buffer, sizeof(buffer)) == 0);
+
+  minifi::io::MappedFileStream missing_stream(path + ".missing");
+  REQUIRE_FALSE(missing_stream.isOpen());
+  const uint8_t* view;
+  size_t view_size;
+  REQUIRE_FALSE(missing_stream.getUnreadView(view, view_size));
+  REQUIRE(missing_stream.read(buffer, sizeof(buffer)) == -1);
+}
+
+TEST_CASE("Piping a MappedFileStream copies the unread content", "[MappedFileStream]") {
+  TestController testController;
+  const std::string path = createFile(testController, "header:payload");
+
+  auto stream = std::make_shared<minifi::io::MappedFileStream>(path, 7);
+  auto output = std::make_shared<minifi::io::BufferStream>();
+  REQUIRE(minifi::internal::pipe(stream, output) == 7);
+  REQUIRE(std::string(reinterpret_cast<const char*>(output->getBuffer()), output->size()) == "payload");
+}
@@ -19,6 +19,7 @@
 
 #include <catch.hpp>
 #include "core/ProcessSession.h"
+#include "FlowFileRecord.h"
 #include "../TestBase.h"
 
 namespace {
@@ -53,6 +54,12 @@ Fixture::Fixture() {
 const core::Relationship Success{"success", "everything is fine"};
 const core::Relationship Failure{"failure", "something has gone awry"};
 
+std::string getAttribute(const core::FlowFile &flow_file, const std::string &key) {
+  std::string value;
+  REQUIRE(flow_file.getAttribute(key, value));
+  return value;
+}
+
 }  // namespace
 
 TEST_CASE("ProcessSession::existsFlowFileInRelationship works", "[existsFlowFileInRelationship]") {
@@ -74,3 +81,51 @@ TEST_CASE("ProcessSession::existsFlowFileInRelationship works", "[existsFlowFile
   REQUIRE(process_session.existsFlowFileInRelationship(Failure));
   REQUIRE(process_session.existsFlowFileInRelationship(Success));
 }
+
+TEST_CASE("ProcessSession::create shares the attributes of the parent until they are modified", "[create]") {
+  Fixture fixture;
+  core::ProcessSession &process_session = fixture.processSession();
+
+  const auto parent = process_session.create();
+  parent->setAttribute("color", "blue");
+  parent->setAttribute("size", "large");
+
+  const auto child = process_session.create(parent);
+  REQUIRE(getAttribute(*child, "color") == "blue");
+  REQUIRE(getAttribute(*child, "size") == "large");
+  REQUIRE(child->getUUIDStr() != parent->getUUIDStr());
+
+  child->setAttribute("color", "red");
+  REQUIRE(getAttribute(*child, "color") == "red");
+  REQUIRE(getAttribute(*parent, "color") == "blue");
+
+  parent->removeAttribute("size");
+  std::string value;
+  REQUIRE_FALSE(parent->getAttribute("size", value));
+  REQUIRE(child->getAttribute("size", value));
+  REQUIRE(value == "large");
+
+  process_session.remove(child);
+  process_session.remove(parent);
+}
+
+TEST_CASE("Copies of a FlowFile share their attributes until either of them is modified", "[attributes]") {
+  auto original = std::make_shared<minifi::FlowFileRecord>();
+  original->setAttribute("key", "value");
+
+  minifi::FlowFileRecord copy;
+  copy = *original;
+  REQUIRE(&copy.getAttributes() == &original->getAttributes());
+
+  copy.setAttribute("key", "other");
+  REQUIRE(&copy.getAttributes() != &original->getAttributes());
+  REQUIRE(getAttribute(*original, "key") == "value");
+  REQUIRE(getAttribute(copy, "key") == "other");
+
+  minifi::FlowFileRecord exposed;
+  auto attributes = exposed.getAttributesPtr();
+  exposed = *original;
+  REQUIRE(&exposed.getAttributes() == attributes);
+  (*attributes)["key"] = "changed";
+  REQUIRE(getAttribute(*original, "key") == "value");
+}
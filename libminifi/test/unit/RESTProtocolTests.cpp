@@ -0,0 +1,122 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <utility>
+#include "../TestBase.h"
+#include "c2/C2Payload.h"
+#include "c2/protocols/RESTProtocol.h"
+#include "rapidjson/document.h"
+
+class TestRESTProtocol : public minifi::c2::RESTProtocol {
+ public:
+  explicit TestRESTProtocol(bool minimize_updates = false) {
+    minimize_updates_ = minimize_updates;
+  }
+
+  std::string serialize(const minifi::c2::C2Payload &payload) {
+    return serializeJsonRootPayload(payload);
+  }
+};
+
+minifi::c2::C2Payload createPayload(const std::string &label, const std::string &key, const std::string &value) {
+  minifi::c2::C2Payload payload(minifi::c2::Operation::HEARTBEAT);
+  payload.setLabel(label);
+  minifi::c2::C2ContentResponse response(minifi::c2::Operation::HEARTBEAT);
+  response.operation_arguments[key] = value;
+  payload.addContent(std::move(response));
+  return payload;
+}
+
+minifi::c2::C2Payload createHeartbeat(const std::string &status) {
+  minifi::c2::C2Payload heartbeat(minifi::c2::Operation::HEARTBEAT);
+  minifi::c2::C2Payload device_info(minifi::c2::Operation::HEARTBEAT);
+  device_info.setLabel("deviceInfo");
+  device_info.addPayload(createPayload("network", "hostname", "localhost"));
+  heartbeat.addPayload(std::move(device_info));
+  minifi::c2::C2Payload agent_info(minifi::c2::Operation::HEARTBEAT);
+  agent_info.setLabel("agentInfo");
+  agent_info.addPayload(createPayload("status", "state", status));
+  heartbeat.addPayload(std::move(agent_info));
+  return heartbeat;
+}
+
+rapidjson::Document parse(const std::string &json) {
+  rapidjson::Document document;
+  REQUIRE_FALSE(document.Parse(json.c_str(), json.length()).HasParseError());
+  return document;
+}
+
+TEST_CASE("RESTProtocol collapses the repeated collapsible payloads into an array", "[collapse]") {
+  minifi::c2::C2Payload components(minifi::c2::Operation::HEARTBEAT);
+  components.setLabel("components");
+  components.addPayload(createPayload("component", "name", "first"));
+  components.addPayload(createPayload("component", "name", "second"));
+  auto unique = createPayload("single", "name", "third");
+  unique.setCollapsible(false);
+  components.addPayload(std::move(unique));
+  minifi::c2::C2Payload heartbeat(minifi::c2::Operation::HEARTBEAT);
+  heartbeat.addPayload(std::move(components));
+
+  TestRESTProtocol protocol;
+  const auto document = parse(protocol.serialize(heartbeat));
+
+  REQUIRE(std::string("heartbeat") == document["operation"].GetString());
+  const auto &serialized = document["components"];
+  REQUIRE(serialized["component"].IsArray());
+  REQUIRE(2 == serialized["component"].Size());
+  REQUIRE(std::string("first") == serialized["component"][0]["name"].GetString());
+  REQUIRE(std::string("second") == serialized["component"][1]["name"].GetString());
+  REQUIRE(serialized["single"].IsObject());
+  REQUIRE(std::string("third") == serialized["single"]["name"].GetString());
+}
+
+TEST_CASE("RESTProtocol sends every section without minimized updates", "[minimize]") {
+  TestRESTProtocol protocol;
+  for (int i = 0; i < 2; ++i) {
+    const auto document = parse(protocol.serialize(createHeartbeat("running")));
+    REQUIRE(document.HasMember("deviceInfo"));
+    REQUIRE(document.HasMember("agentInfo"));
+  }
+}
+
+TEST_CASE("RESTProtocol leaves out the unchanged sections with minimized updates", "[minimize]") {
+  TestRESTProtocol protocol(true);
+
+  auto document = parse(protocol.serialize(createHeartbeat("running")));
+  REQUIRE(document.HasMember("deviceInfo"));
+  REQUIRE(document.HasMember("agentInfo"));
+
+  document = parse(protocol.serialize(createHeartbeat("running")));
+  REQUIRE(std::string("heartbeat") == document["operation"].GetString());
+  REQUIRE_FALSE(document.HasMember("deviceInfo"));
+  REQUIRE_FALSE(document.HasMember("agentInfo"));
+
+  document = parse(protocol.serialize(createHeartbeat("stopped")));
+  REQUIRE_FALSE(document.HasMember("deviceInfo"));
+  REQUIRE(document.HasMember("agentInfo"));
+  REQUIRE(std::string("stopped") == document["agentInfo"]["status"]["state"].GetString());
+
+  // the changed section is tracked in its new form
+  document = parse(protocol.serialize(createHeartbeat("stopped")));
+  REQUIRE_FALSE(document.HasMember("agentInfo"));
+
+  document = parse(protocol.serialize(createHeartbeat("running")));
+  REQUIRE_FALSE(document.HasMember("deviceInfo"));
+  REQUIRE(std::string("running") == document["agentInfo"]["status"]["state"].GetString());
+}
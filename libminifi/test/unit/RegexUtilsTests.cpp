@@ -17,6 +17,7 @@
  */
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Exception.h"
@@ -81,3 +82,25 @@ TEST_CASE("Regex::matchesFullInput works correctly", "[matchesFullInput]") {
   REQUIRE(Regex::matchesFullInput("(in|out)put", "input") == true);
   REQUIRE(Regex::matchesFullInput("inpu[aeiou]*", "input") == false);
 }
+
+TEST_CASE("Regex::search finds the groups in place", "[search]") {
+  const std::string input = "Speed limit 130 | Speed limit 80";
+  const Regex rgx("Speed limit ([0-9]+)( mph)?");
+  std::vector<std::pair<const char*, const char*>> groups;
+
+  const char* begin = input.data();
+  const char* end = input.data() + input.size();
+  REQUIRE(rgx.search(begin, end, groups));
+  REQUIRE(3 == groups.size());
+  REQUIRE("Speed limit 130" == std::string(groups[0].first, groups[0].second));
+  REQUIRE("130" == std::string(groups[1].first, groups[1].second));
+  REQUIRE(groups[2].first == groups[2].second);
+
+  REQUIRE(rgx.search(groups[0].second, end, groups));
+  REQUIRE("80" == std::string(groups[1].first, groups[1].second));
+  REQUIRE(groups[0].second == end);
+
+  // the range ends before the second match
+  REQUIRE_FALSE(rgx.search(begin + 1, begin + input.find(" 80"), groups));
+  REQUIRE(groups.empty());
+}
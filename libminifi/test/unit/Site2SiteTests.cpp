@@ -70,6 +70,7 @@ TEST_CASE("TestSiteToSiteVerifySend", "[S2S3]") {
 
   std::unique_ptr<minifi::sitetosite::SiteToSitePeer> peer = std::unique_ptr<minifi::sitetosite::SiteToSitePeer>(
       new minifi::sitetosite::SiteToSitePeer(std::unique_ptr<minifi::io::BaseStream>(collector), "fake_host", 65433, ""));
+  auto peer_ptr = peer.get();
 
   minifi::sitetosite::RawSiteToSiteClient protocol(std::move(peer));
 
@@ -79,32 +80,21 @@ TEST_CASE("TestSiteToSiteVerifySend", "[S2S3]") {
 
   REQUIRE(true == protocol.bootstrap());
 
-  REQUIRE(collector->get_next_client_response() == "NiFi");
-  collector->get_next_client_response();
-  REQUIRE(collector->get_next_client_response() == "SocketFlowFileProtocol");
-  collector->get_next_client_response();
-  collector->get_next_client_response();
-  collector->get_next_client_response();
-  collector->get_next_client_response();
-  REQUIRE(collector->get_next_client_response() == "nifi://fake_host:65433");
-  collector->get_next_client_response();
-  collector->get_next_client_response();
-  REQUIRE(collector->get_next_client_response() == "GZIP");
-  collector->get_next_client_response();
-  REQUIRE(collector->get_next_client_response() == "false");
-  collector->get_next_client_response();
-  REQUIRE(collector->get_next_client_response() == "PORT_IDENTIFIER");
-  collector->get_next_client_response();
-  REQUIRE(utils::StringUtils::equalsIgnoreCase(collector->get_next_client_response(), "c56a4180-65aa-42ec-a945-5fd21dec0538"));
-  collector->get_next_client_response();
-  REQUIRE(collector->get_next_client_response() == "REQUEST_EXPIRATION_MILLIS");
-  collector->get_next_client_response();
-  REQUIRE(collector->get_next_client_response() == "30000");
-  collector->get_next_client_response();
-  REQUIRE(collector->get_next_client_response() == "NEGOTIATE_FLOWFILE_CODEC");
-  collector->get_next_client_response();
-  REQUIRE(collector->get_next_client_response() == "StandardFlowFileCodec");
-  collector->get_next_client_response();  // codec version
+  REQUIRE(collector->get_next_client_bytes(4) == "NiFi");
+  REQUIRE(collector->get_next_client_string() == "SocketFlowFileProtocol");
+  collector->get_next_client_integral<uint32_t>();  // protocol version
+  collector->get_next_client_string();  // communication identifier
+  REQUIRE(collector->get_next_client_string() == "nifi://fake_host:65433");
+  REQUIRE(collector->get_next_client_integral<uint32_t>() == 3);
+  REQUIRE(collector->get_next_client_string() == "GZIP");
+  REQUIRE(collector->get_next_client_string() == "false");
+  REQUIRE(collector->get_next_client_string() == "PORT_IDENTIFIER");
+  REQUIRE(utils::StringUtils::equalsIgnoreCase(collector->get_next_client_string(), "c56a4180-65aa-42ec-a945-5fd21dec0538"));
+  REQUIRE(collector->get_next_client_string() == "REQUEST_EXPIRATION_MILLIS");
+  REQUIRE(collector->get_next_client_string() == "30000");
+  REQUIRE(collector->get_next_client_string() == "NEGOTIATE_FLOWFILE_CODEC");
+  REQUIRE(collector->get_next_client_string() == "StandardFlowFileCodec");
+  collector->get_next_client_integral<uint32_t>();  // codec version
 
   // start to send the stuff
   // Create the transaction
@@ -113,16 +103,17 @@ TEST_CASE("TestSiteToSiteVerifySend", "[S2S3]") {
   transaction = protocol.createTransaction(minifi::sitetosite::SEND);
   REQUIRE(transaction);
   auto transactionID = transaction->getUUID();
-  collector->get_next_client_response();
-  REQUIRE(collector->get_next_client_response() == "SEND_FLOWFILES");
   std::map<std::string, std::string> attributes;
   std::shared_ptr<logging::Logger> logger = nullptr;
   minifi::sitetosite::DataPacket packet(logger, transaction, attributes, payload);
   REQUIRE(protocol.send(transactionID, &packet, nullptr, nullptr) == 0);
-  collector->get_next_client_response();
-  collector->get_next_client_response();
-  std::string rx_payload = collector->get_next_client_response();
-  REQUIRE(payload == rx_payload);
+  // nothing is read back until the transaction is confirmed, so the request and the flow file are still buffered
+  REQUIRE_THROWS(collector->get_next_client_string());
+  REQUIRE(peer_ptr->flush() == 0);
+  REQUIRE(collector->get_next_client_string() == "SEND_FLOWFILES");
+  REQUIRE(collector->get_next_client_integral<uint32_t>() == 0);  // number of attributes
+  REQUIRE(collector->get_next_client_integral<uint64_t>() == payload.size());
+  REQUIRE(collector->get_next_client_bytes(payload.size()) == payload);
 }
 
 TEST_CASE("TestSiteToSiteVerifyNegotiationFail", "[S2S4]") {
@@ -18,7 +18,8 @@
 #ifndef LIBMINIFI_TEST_UNIT_SITE2SITE_HELPER_H_
 #define LIBMINIFI_TEST_UNIT_SITE2SITE_HELPER_H_
 
-#include <queue>
+#include <stdexcept>
+#include <string>
 #include "io/BufferStream.h"
 #include "io/EndianCheck.h"
 #include "core/Core.h"
@@ -28,7 +29,8 @@
 class SiteToSiteResponder : public minifi::io::BaseStream {
  private:
   minifi::io::BufferStream server_responses_;
-  std::queue<std::string> client_responses_;
+  // everything the client wrote, the protocol may coalesce several fields into one write
+  minifi::io::BufferStream client_output_;
  public:
   SiteToSiteResponder() = default;
   // initialize
@@ -41,13 +43,37 @@ class SiteToSiteResponder : public minifi::io::BaseStream {
   }
 
   int write(const uint8_t *value, int size) override {
-    client_responses_.push(std::string(reinterpret_cast<const char*>(value), size));
-    return size;
+    return client_output_.write(value, size);
   }
 
-  std::string get_next_client_response() {
-    std::string ret = client_responses_.front();
-    client_responses_.pop();
+  /**
+   * Takes the next bytes the client wrote.
+   */
+  std::string get_next_client_bytes(size_t size) {
+    std::string ret(size, '\0');
+    if (client_output_.read(reinterpret_cast<uint8_t*>(&ret[0]), static_cast<int>(size)) != static_cast<int>(size)) {
+      throw std::runtime_error("The client wrote less than expected");
+    }
+    return ret;
+  }
+
+  /**
+   * Takes the next length prefixed string the client wrote.
+   */
+  std::string get_next_client_string() {
+    std::string ret;
+    if (client_output_.read(ret) <= 0) {
+      throw std::runtime_error("The client did not write a string");
+    }
+    return ret;
+  }
+
+  template<typename Integral>
+  Integral get_next_client_integral() {
+    Integral ret;
+    if (client_output_.read(ret) != sizeof(Integral)) {
+      throw std::runtime_error("The client did not write an integral");
+    }
     return ret;
   }
 
@@ -0,0 +1,148 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/repository/SlabContentRepository.h"
+#include "../TestBase.h"
+
+namespace {
+
+std::shared_ptr<core::repository::SlabContentRepository> createRepository(const std::string& directory, const std::string& max_segment_size = "") {
+  auto config = std::make_shared<minifi::Configure>();
+  config->set(minifi::Configure::nifi_dbcontent_repository_directory_default, directory);
+  if (!max_segment_size.empty()) {
+    config->set(minifi::Configure::nifi_slab_content_repository_max_segment_size, max_segment_size);
+  }
+  auto repository = std::make_shared<core::repository::SlabContentRepository>();
+  REQUIRE(repository->initialize(config));
+  return repository;
+}
+
+std::shared_ptr<minifi::ResourceClaim> writeClaim(const std::shared_ptr<core::ContentRepository>& repository, const std::string& content) {
+  auto session = repository->createSession();
+  auto claim = session->create();
+  auto stream = session->write(claim);
+  REQUIRE(stream->write(reinterpret_cast<const uint8_t*>(content.data()), content.size()) == static_cast<int>(content.size()));
+  session->commit();
+  return claim;
+}
+
+std::string readClaim(const std::shared_ptr<core::ContentRepository>& repository, const minifi::ResourceClaim& claim) {
+  auto stream = repository->read(claim);
+  REQUIRE(stream);
+  std::vector<uint8_t> buffer;
+  REQUIRE(stream->read(buffer, stream->size()) == static_cast<int>(stream->size()));
+  return std::string(buffer.begin(), buffer.end());
+}
+
+size_t countSegmentFiles(const std::string& directory) {
+  size_t count = 0;
+  utils::file::FileUtils::list_dir(directory, [&count](const std::string&, const std::string& file_name) {
+    if (file_name.find(".slab") != std::string::npos) {
+      ++count;
+    }
+    return true;
+  }, logging::LoggerFactory<core::repository::SlabContentRepository>::getLogger(), false);
+  return count;
+}
+
+}  // namespace
+
+TEST_CASE("SlabContentRepository packs many claims into one segment", "[SlabContentRepository]") {
+  TestController testController;
+  char format[] = "/var/tmp/slab_repo.XXXXXX";
+  const std::string directory = testController.createTempDirectory(format);
+  auto repository = createRepository(directory);
+
+  std::vector<std::shared_ptr<minifi::ResourceClaim>> claims;
+  for (int i = 0; i < 100; ++i) {
+    claims.push_back(writeClaim(repository, "content " + std::to_string(i)));
+  }
+  REQUIRE(countSegmentFiles(directory) == 1);
+  for (int i = 0; i < 100; ++i) {
+    REQUIRE(repository->exists(*claims[i]));
+    REQUIRE(readClaim(repository, *claims[i]) == "content " + std::to_string(i));
+  }
+
+  auto stream = repository->read(*claims[42]);
+  stream->seek(8);
+  std::vector<uint8_t> buffer;
+  REQUIRE(stream->read(buffer, 2) == 2);
+  REQUIRE(std::string(buffer.begin(), buffer.end()) == "42");
+}
+
+TEST_CASE("SlabContentRepository deletes segments once their claims are gone", "[SlabContentRepository]") {
+  TestController testController;
+  char format[] = "/var/tmp/slab_repo.XXXXXX";
+  const std::string directory = testController.createTempDirectory(format);
+  auto repository = createRepository(directory, "64");
+
+  auto first = writeClaim(repository, std::string(100, 'a'));
+  auto second = writeClaim(repository, std::string(100, 'b'));
+  auto third = writeClaim(repository, std::string(100, 'c'));
+  // every claim exceeds the segment size, so each one starts a new segment
+  REQUIRE(repository->getSegmentCount() == 3);
+
+  REQUIRE(repository->remove(*second));
+  REQUIRE_FALSE(repository->exists(*second));
+  REQUIRE(repository->getSegmentCount() == 3);  // the removal record went to a new segment, the one of the third claim is full
+
+  REQUIRE(repository->remove(*first));
+  REQUIRE(readClaim(repository, *third) == std::string(100, 'c'));
+  REQUIRE(countSegmentFiles(directory) == repository->getSegmentCount());
+  REQUIRE_FALSE(repository->remove(*first));
+}
+
+TEST_CASE("SlabContentRepository recovers claims from its segments", "[SlabContentRepository]") {
+  TestController testController;
+  char format[] = "/var/tmp/slab_repo.XXXXXX";
+  const std::string directory = testController.createTempDirectory(format);
+
+  minifi::ResourceClaim::Path kept_path;
+  minifi::ResourceClaim::Path appended_path;
+  minifi::ResourceClaim::Path removed_path;
+  {
+    auto repository = createRepository(directory, "64");
+    auto kept = writeClaim(repository, std::string(100, 'k'));
+    auto appended = writeClaim(repository, "first");
+    auto removed = writeClaim(repository, std::string(100, 'r'));
+    {
+      auto session = repository->createSession();
+      auto stream = session->write(appended, core::ContentSession::WriteMode::APPEND);
+      REQUIRE(stream->write(reinterpret_cast<const uint8_t*>("-last"), 5) == 5);
+      session->commit();
+    }
+    REQUIRE(repository->remove(*removed));
+    kept_path = kept->getContentFullPath();
+    appended_path = appended->getContentFullPath();
+    removed_path = removed->getContentFullPath();
+    repository->stop();
+  }
+
+  auto repository = createRepository(directory, "64");
+  minifi::ResourceClaim kept(kept_path, nullptr);
+  minifi::ResourceClaim appended(appended_path, nullptr);
+  minifi::ResourceClaim removed(removed_path, nullptr);
+  REQUIRE(readClaim(repository, kept) == std::string(100, 'k'));
+  REQUIRE(readClaim(repository, appended) == "first-last");
+  REQUIRE_FALSE(repository->exists(removed));
+  REQUIRE(countSegmentFiles(directory) == repository->getSegmentCount());
+}
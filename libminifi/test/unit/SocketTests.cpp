@@ -26,6 +26,7 @@
 #include "../TestBase.h"
 #include "io/StreamFactory.h"
 #include "io/Sockets.h"
+#include "io/SocketSelector.h"
 #include "utils/ThreadPool.h"
 using Sockets = org::apache::nifi::minifi::io::Socket;
 
@@ -171,6 +172,65 @@ TEST_CASE("TestSocketWriteTestAfterClose", "[TestSocket7]") {
   server.close();
 }
 
+#ifndef WIN32
+TEST_CASE("SocketSelector reports the readable descriptors", "[TestSocketSelector]") {
+  int fds[2];
+  REQUIRE(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+  minifi::io::SocketSelector selector;
+  REQUIRE(selector.wait(std::chrono::milliseconds(0)).empty());
+
+  REQUIRE(selector.add(fds[0]));
+  REQUIRE(selector.add(fds[0]));
+  REQUIRE(1 == selector.size());
+  REQUIRE(selector.wait(std::chrono::milliseconds(10)).empty());
+
+  REQUIRE(1 == ::write(fds[1], "a", 1));
+  REQUIRE(std::vector<int>{ fds[0] } == selector.wait(std::chrono::milliseconds(1000)));
+  // the descriptor stays ready until it is drained
+  REQUIRE(std::vector<int>{ fds[0] } == selector.wait(std::chrono::milliseconds(0)));
+
+  char c;
+  REQUIRE(1 == ::read(fds[0], &c, 1));
+  REQUIRE(selector.wait(std::chrono::milliseconds(0)).empty());
+
+  ::close(fds[1]);
+  // the hang up is reported as readiness
+  REQUIRE(std::vector<int>{ fds[0] } == selector.wait(std::chrono::milliseconds(1000)));
+
+  selector.remove(fds[0]);
+  REQUIRE(0 == selector.size());
+  REQUIRE(selector.wait(std::chrono::milliseconds(0)).empty());
+  ::close(fds[0]);
+}
+
+TEST_CASE("SocketSelector can be cleared while another thread is waiting", "[TestSocketSelector]") {
+  int fds[2];
+  REQUIRE(0 == socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+  minifi::io::SocketSelector selector;
+  REQUIRE(selector.add(fds[0]));
+  std::thread waiter([&selector] {
+    for (int i = 0; i < 20; ++i) {
+      selector.wait(std::chrono::milliseconds(10));
+    }
+  });
+  for (int i = 0; i < 20; ++i) {
+    selector.clear();
+    REQUIRE(0 == selector.size());
+    REQUIRE(selector.add(fds[0]));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  waiter.join();
+
+  REQUIRE(1 == selector.size());
+  REQUIRE(1 == ::write(fds[1], "a", 1));
+  REQUIRE(std::vector<int>{ fds[0] } == selector.wait(std::chrono::milliseconds(1000)));
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+#endif  // WIN32
+
 #ifdef OPENSSL_SUPPORT
 std::atomic<uint8_t> counter;
 std::mt19937_64 seed { std::random_device { }() };
@@ -25,6 +25,7 @@
 #include <utility>
 #include "../TestBase.h"
 #include "io/BaseStream.h"
+#include "io/BufferedStream.h"
 
 TEST_CASE("TestReadData", "[testread]") {
   auto base = std::make_shared<minifi::io::BufferStream>();
@@ -77,3 +78,51 @@ TEST_CASE("TestWrite1", "[testwrite]") {
   REQUIRE(8 == base->read(reinterpret_cast<uint8_t*>(const_cast<char*>(bytes.data())), 8));
   REQUIRE(bytes == "\x01\x02\x03\x04\x05\x06\x07\x08");
 }
+
+TEST_CASE("BufferedStream coalesces small writes", "[testbuffered]") {
+  minifi::io::BufferStream base;
+  minifi::io::BufferedStream buffered(gsl::make_not_null(&base), 16);
+
+  REQUIRE(4 == buffered.write(static_cast<uint32_t>(1)));
+  REQUIRE(6 == buffered.write(std::string("test")));
+  REQUIRE(base.size() == 0);
+  REQUIRE(buffered.bufferedSize() == 10);
+
+  // does not fit next to the buffered data
+  REQUIRE(8 == buffered.write(static_cast<uint64_t>(2)));
+  REQUIRE(base.size() == 10);
+  REQUIRE(buffered.bufferedSize() == 8);
+
+  // larger than the buffer, passed on after the buffered data
+  const std::string large(32, 'x');
+  REQUIRE(32 == buffered.write(reinterpret_cast<const uint8_t*>(large.data()), gsl::narrow<int>(large.size())));
+  REQUIRE(base.size() == 50);
+  REQUIRE(buffered.bufferedSize() == 0);
+
+  REQUIRE(1 == buffered.write(static_cast<uint8_t>(3)));
+  REQUIRE(buffered.flush() == 0);
+  REQUIRE(base.size() == 51);
+
+  uint32_t first = 0;
+  std::string second;
+  uint64_t third = 0;
+  REQUIRE(4 == base.read(first));
+  REQUIRE(6 == base.read(second));
+  REQUIRE(8 == base.read(third));
+  REQUIRE(first == 1);
+  REQUIRE(second == "test");
+  REQUIRE(third == 2);
+}
+
+TEST_CASE("BufferedStream flushes before reading", "[testbuffered]") {
+  minifi::io::BufferStream base;
+  minifi::io::BufferedStream buffered(gsl::make_not_null(&base), 16);
+
+  REQUIRE(4 == buffered.write(static_cast<uint32_t>(42)));
+  REQUIRE(base.size() == 0);
+
+  uint32_t value = 0;
+  REQUIRE(4 == buffered.read(value));
+  REQUIRE(value == 42);
+  REQUIRE(buffered.bufferedSize() == 0);
+}
@@ -21,6 +21,7 @@
 #include <memory>
 #include "../TestBase.h"
 #include "utils/ThreadPool.h"
+#include "utils/GeneralUtils.h"
 
 bool function() {
   return true;
@@ -94,3 +95,129 @@ TEST_CASE("ThreadPoolTest2", "[TPT2]") {
   fut.wait();
   REQUIRE(20 == fut.get());
 }
+
+TEST_CASE("ThreadPool wakes up tasks waiting for work when notified", "[TPT3]") {
+  std::atomic<int> runs{0};
+  utils::ThreadPool<utils::TaskRescheduleInfo> pool(2);
+  std::function<utils::TaskRescheduleInfo()> f_ex = [&runs] {
+    if (runs++ == 0) {
+      return utils::TaskRescheduleInfo::WaitForWork(std::chrono::minutes(1));
+    }
+    return utils::TaskRescheduleInfo::Done();
+  };
+  utils::Worker<utils::TaskRescheduleInfo> functor(f_ex, "id", utils::make_unique<utils::ComplexMonitor>());
+  pool.start();
+  std::future<utils::TaskRescheduleInfo> fut;
+  REQUIRE(true == pool.execute(std::move(functor), fut));
+  while (runs == 0) {
+    std::this_thread::yield();
+  }
+  // notifications of other tasks are ignored
+  pool.notifyWork("other id");
+  REQUIRE(std::future_status::timeout == fut.wait_for(std::chrono::milliseconds(100)));
+  // the task may or may not be idle in the delayed queue yet, it has to be run again in both cases
+  pool.notifyWork("id");
+  REQUIRE(std::future_status::ready == fut.wait_for(std::chrono::seconds(10)));
+  REQUIRE(2 == runs);
+}
+
+TEST_CASE("ThreadPool does not wake up yielding tasks when notified", "[TPT4]") {
+  std::atomic<int> runs{0};
+  utils::ThreadPool<utils::TaskRescheduleInfo> pool(2);
+  std::function<utils::TaskRescheduleInfo()> f_ex = [&runs] {
+    ++runs;
+    return utils::TaskRescheduleInfo::RetryIn(std::chrono::minutes(1));
+  };
+  utils::Worker<utils::TaskRescheduleInfo> functor(f_ex, "id", utils::make_unique<utils::ComplexMonitor>());
+  pool.start();
+  std::future<utils::TaskRescheduleInfo> fut;
+  REQUIRE(true == pool.execute(std::move(functor), fut));
+  while (runs == 0) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  pool.notifyWork("id");
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  REQUIRE(1 == runs);
+  pool.shutdown();
+}
+
+TEST_CASE("ThreadPool notifications are used up by the next run of the task", "[TPT7]") {
+  std::atomic<int> runs{0};
+  utils::ThreadPool<utils::TaskRescheduleInfo> pool(2);
+  std::function<utils::TaskRescheduleInfo()> f_ex = [&runs, &pool] {
+    switch (runs++) {
+      case 0:
+        // work arrives while the task is running, then it yields
+        pool.notifyWork("id");
+        return utils::TaskRescheduleInfo::RetryIn(std::chrono::milliseconds(10));
+      case 1:
+        return utils::TaskRescheduleInfo::WaitForWork(std::chrono::minutes(1));
+      default:
+        return utils::TaskRescheduleInfo::Done();
+    }
+  };
+  pool.start();
+  std::future<utils::TaskRescheduleInfo> fut;
+  REQUIRE(pool.execute(utils::Worker<utils::TaskRescheduleInfo>(f_ex, "id", utils::make_unique<utils::ComplexMonitor>()), fut));
+  const auto notifier = pool.getWorkNotifier("id");
+  REQUIRE(notifier);
+  REQUIRE_FALSE(pool.getWorkNotifier("other id"));
+  // the notification was handled by the run after the yield, so the task stays idle
+  REQUIRE(std::future_status::timeout == fut.wait_for(std::chrono::milliseconds(200)));
+  REQUIRE(2 == runs);
+  notifier();
+  REQUIRE(std::future_status::ready == fut.wait_for(std::chrono::seconds(10)));
+  REQUIRE(3 == runs);
+}
+
+TEST_CASE("ThreadPool stopped tasks are not revived by new tasks with the same identifier", "[TPT5]") {
+  std::atomic<int> old_runs{0};
+  std::atomic<int> new_runs{0};
+  utils::ThreadPool<utils::TaskRescheduleInfo> pool(4);
+  pool.start();
+  std::function<utils::TaskRescheduleInfo()> old_task = [&old_runs] {
+    ++old_runs;
+    return utils::TaskRescheduleInfo::RetryIn(std::chrono::milliseconds(1));
+  };
+  std::future<utils::TaskRescheduleInfo> old_future;
+  REQUIRE(pool.execute(utils::Worker<utils::TaskRescheduleInfo>(old_task, "id", utils::make_unique<utils::ComplexMonitor>()), old_future));
+  while (old_runs == 0) {
+    std::this_thread::yield();
+  }
+  REQUIRE(pool.isTaskRunning("id"));
+  pool.stopTasks("id");
+  REQUIRE_FALSE(pool.isTaskRunning("id"));
+
+  std::function<utils::TaskRescheduleInfo()> new_task = [&new_runs] {
+    return ++new_runs < 10 ? utils::TaskRescheduleInfo::RetryImmediately() : utils::TaskRescheduleInfo::Done();
+  };
+  std::future<utils::TaskRescheduleInfo> new_future;
+  REQUIRE(pool.execute(utils::Worker<utils::TaskRescheduleInfo>(new_task, "id", utils::make_unique<utils::ComplexMonitor>()), new_future));
+  REQUIRE(pool.isTaskRunning("id"));
+  REQUIRE(std::future_status::ready == new_future.wait_for(std::chrono::seconds(10)));
+  REQUIRE(10 == new_runs);
+  // let a possibly running iteration of the old task finish
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const int old_runs_after_stop = old_runs;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  REQUIRE(old_runs_after_stop == old_runs);
+}
+
+TEST_CASE("ThreadPool runs many short tasks on every worker", "[TPT6]") {
+  constexpr int task_count = 100;
+  constexpr int runs_per_task = 100;
+  std::atomic<int> runs{0};
+  utils::ThreadPool<int> pool(4);
+  pool.start();
+  std::vector<std::future<int>> futures(task_count);
+  for (int i = 0; i < task_count; ++i) {
+    std::function<int()> f_ex = [&runs] { ++runs; return 1; };
+    std::unique_ptr<utils::AfterExecute<int>> after_execute = std::unique_ptr<utils::AfterExecute<int>>(new WorkerNumberExecutions(runs_per_task));
+    REQUIRE(pool.execute(utils::Worker<int>(f_ex, std::to_string(i), std::move(after_execute)), futures[i]));
+  }
+  for (auto &future : futures) {
+    REQUIRE(std::future_status::ready == future.wait_for(std::chrono::seconds(60)));
+  }
+  REQUIRE(task_count * runs_per_task == runs);
+}
@@ -118,7 +118,7 @@ class ExecutionPlan {
 
   bool setFailureStrategy(FailureStrategy start);
 
-  std::set<std::shared_ptr<provenance::ProvenanceEventRecord>> getProvenanceRecords();
+  std::vector<std::shared_ptr<provenance::ProvenanceEventRecord>> getProvenanceRecords();
 
   std::shared_ptr<core::FlowFile> getCurrentFlowFile();
 